@@ -0,0 +1,236 @@
+// Reading thousands of files — one at a time with ifstream vs AsyncFileReader
+//
+// Generates a directory of files (2000 × 128 KiB by default, reused if present) and
+// reads every one of them whole. The sequential loops have one read outstanding at a
+// time; AsyncFileReader keeps --depth reads in flight, with io_uring and with its
+// thread-pool fallback.
+//
+// --cold (the case that matters): before each method every file's pages are dropped
+// with posix_fadvise(DONTNEED), so reads go to the device. Warm runs show the
+// per-file overhead only: open, fstat, allocation, syscalls.
+//
+// Every method checksums the contents; a different checksum is reported as wrong.
+//
+// Compile: g++ -std=c++20 -O2 -pthread bench-async-read.cpp -o bench-async-read
+// Run    : ./bench-async-read [--files=2000] [--size-kb=128] [--depth=32] [--dir=/tmp/bench-async-read] [--cold]
+
+#include "../tips/async-file-reader.hpp"
+#include "../tips/fast-writer.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct t_AsyncOptions
+{
+    std::string   directory = "/tmp/bench-async-read";
+    std::size_t   files     = 2000;
+    std::size_t   size_kb   = 128;
+    unsigned      depth     = 32;
+    bool          cold      = false;
+};
+
+struct t_Digest
+{
+    std::uint64_t files = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t sum   = 0;   // order-independent: files complete in any order
+
+    void add(std::size_t index, std::string_view data)
+    {
+        std::uint64_t hash = 1469598103934665603ull ^ index;
+        for (std::size_t i = 0; i < data.size(); i += 64)   // one byte per cache line is enough
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+        files++;
+        bytes += data.size();
+        sum += hash;
+    }
+
+    bool operator==(const t_Digest&) const = default;
+};
+
+// ---------------------------------------------------------------
+// Input files
+// ---------------------------------------------------------------
+static bool generate_files(const t_AsyncOptions& options, std::vector<std::string>& paths)
+{
+    ::mkdir(options.directory.c_str(), 0755);
+    std::mt19937_64 rng(11);
+    std::size_t     created = 0;
+    for (std::size_t i = 0; i < options.files; i++)
+    {
+        std::string path = options.directory + "/file-" + std::to_string(i) + ".txt";
+        paths.push_back(path);
+
+        // Sizes vary ±50% around size_kb, deterministically per index
+        std::size_t size = (options.size_kb << 10) / 2 + (rng() % (options.size_kb << 10));
+        struct stat info;
+        if (::stat(path.c_str(), &info) == 0 && std::size_t(info.st_size) == size)
+            continue;
+
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            std::perror(path.c_str());
+            return false;
+        }
+        if (created++ == 0)
+        {
+            std::printf("generating %zu files in %s…\n", options.files, options.directory.c_str());
+            std::fflush(stdout);
+        }
+        FastWriter out(fd);
+        for (std::size_t written = 0; written < size; written++)
+            out.put(char('a' + (written * 7 + i) % 26));
+        bool ok = out.flush();
+        ::close(fd);
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+static void drop_from_page_cache(const std::vector<std::string>& paths)
+{
+    for (const std::string& path : paths)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::fdatasync(fd);   // dirty pages (a file just generated) are not dropped
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// Methods
+// ---------------------------------------------------------------
+// file-handling.md "Method 3: Pre-allocate with file size", once per file
+static t_Digest sequential_ifstream(const std::vector<std::string>& paths, const t_AsyncOptions&)
+{
+    t_Digest    digest;
+    std::string content;
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        std::ifstream   file(paths[i], std::ios::binary | std::ios::ate);
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        content.resize(std::size_t(size));
+        file.read(content.data(), size);
+        digest.add(i, content);
+    }
+    return digest;
+}
+
+// The same loop with the engine's own open + fstat + pread, to separate the
+// cost of ifstream from the cost of waiting
+static t_Digest sequential_pread(const std::vector<std::string>& paths, const t_AsyncOptions&)
+{
+    t_Digest digest;
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        int        fd;
+        t_FileData file = open_for_reading(i, paths[i], fd);
+        if (file.error)
+            continue;
+        std::size_t done = 0;
+        while (done < file.size)
+        {
+            ssize_t got = ::pread(fd, file.data.get() + done, file.size - done, off_t(done));
+            if (got <= 0)
+                break;
+            done += std::size_t(got);
+        }
+        ::close(fd);
+        digest.add(i, file.text());
+    }
+    return digest;
+}
+
+static t_Digest async_reader(const std::vector<std::string>& paths, const t_AsyncOptions& options,
+                             t_ReadBackend backend)
+{
+    t_Digest        digest;
+    AsyncFileReader reader(paths, { options.depth, 1 << 20, backend });
+    if (backend != t_ReadBackend::ThreadPool && reader.backend() != backend)
+        std::printf("  (io_uring unavailable: %s — measuring the thread pool)\n",
+                    std::strerror(reader.io_uring_error()));
+    reader.for_each([&](t_FileData file) { digest.add(file.index, file.text()); });
+    return digest;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+template<typename Method>
+static void measure(const char* name, const std::vector<std::string>& paths, const t_AsyncOptions& options,
+                    const t_Digest& expected, Method method)
+{
+    if (options.cold)
+        drop_from_page_cache(paths);
+
+    auto     start   = std::chrono::steady_clock::now();
+    t_Digest digest  = method(paths, options);
+    double   seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("  %-34s %7.3f s %8.0f MB/s %8.1f us/file  %s\n", name, seconds, double(expected.bytes) / 1e6 / seconds,
+                seconds * 1e6 / double(expected.files), digest == expected ? "" : "WRONG RESULT");
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    t_AsyncOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--files=", 8) == 0)
+            options.files = std::strtoull(argv[i] + 8, nullptr, 10);
+        else if (std::strncmp(argv[i], "--size-kb=", 10) == 0)
+            options.size_kb = std::strtoull(argv[i] + 10, nullptr, 10);
+        else if (std::strncmp(argv[i], "--depth=", 8) == 0)
+            options.depth = unsigned(std::strtoul(argv[i] + 8, nullptr, 10));
+        else if (std::strncmp(argv[i], "--dir=", 6) == 0)
+            options.directory = argv[i] + 6;
+        else if (std::strcmp(argv[i], "--cold") == 0)
+            options.cold = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--files=2000] [--size-kb=128] [--depth=32] [--dir=path] [--cold]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (options.files == 0 || options.size_kb == 0)
+        return 1;
+
+    std::vector<std::string> paths;
+    if (!generate_files(options, paths))
+        return 1;
+
+    // Reference result, and the page cache warmed for the warm runs
+    t_Digest expected = sequential_pread(paths, options);
+    std::printf("%" PRIu64 " files, %.0f MB, %s page cache, queue depth %u\n\n", expected.files,
+                double(expected.bytes) / 1e6, options.cold ? "cold" : "warm", options.depth);
+
+    measure("sequential ifstream", paths, options, expected, sequential_ifstream);
+    measure("sequential pread", paths, options, expected, sequential_pread);
+    measure("AsyncFileReader, io_uring", paths, options, expected,
+            [](const std::vector<std::string>& p, const t_AsyncOptions& o)
+            { return async_reader(p, o, t_ReadBackend::IoUring); });
+    measure("AsyncFileReader, thread pool", paths, options, expected,
+            [](const std::vector<std::string>& p, const t_AsyncOptions& o)
+            { return async_reader(p, o, t_ReadBackend::ThreadPool); });
+    return 0;
+}
@@ -0,0 +1,414 @@
+// Compare two benchmark result files (written with --json) and flag regressions
+//
+// A fixed "more than 5% slower" rule is either too strict or too loose: a benchmark
+// with 0.5% noise that got 3% slower is a real regression, one with 10% noise that
+// moved 6% is not. Instead, for every benchmark present in both files:
+//
+//   1. a p-value that does not assume the noise is normal (it never is: it has a
+//      long right tail) — see below for how runs are treated
+//   2. Holm-Bonferroni correction of the p-values: with 30 benchmarks at α = 0.01,
+//      uncorrected tests would report a false regression every few comparisons
+//   3. bootstrap confidence interval (at 1 - α) for the ratio of the medians, so the
+//      report says how big the change is, not only that there is one
+//
+// Runs, not samples, are the unit. Samples of one run share its memory layout, CPU
+// frequency and background noise, so they are not independent: two runs of the same
+// binary differ by more than their samples suggest. With several runs per side
+// (appended to one file, as compare-commits.sh does) the interval and the p-value
+// come from a hierarchical bootstrap — resample the runs, then the samples within
+// each chosen run — so run-to-run variation is part of the test. With a single run
+// per side the samples have to stand in for it: Mann-Whitney U on the samples, and a
+// warning that an A/A comparison (the same binary on both sides) may well fail.
+//
+// A benchmark is "slower" or "faster" only if the corrected p-value is below α, the
+// interval excludes no change and the change is at least --min-change (default 1%).
+// Before using this as a CI gate, run an A/A comparison on the target machine: it
+// must report nothing, or --min-change has to grow to that machine's noise.
+//
+// Compile: g++ -std=c++20 -O2 bench-compare.cpp -o bench-compare
+// Run    : ./bench-compare baseline.jsonl candidate.jsonl [--alpha=0.01] [--min-change=0.01]
+//          (exit status 1 when anything got slower — usable as a CI gate)
+//          compare-commits.sh builds and runs the suites at two commits and calls this.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------
+// Reading the JSON lines written by benchmark.hpp
+// ---------------------------------------------------------------
+// Not a general JSON parser: the records are flat objects with string, number and
+// number-array values, one per line, so looking up "key": is enough.
+static const char* find_value(const std::string& line, const char* key)
+{
+    std::string pattern = std::string("\"") + key + "\":";
+    for (std::size_t at = line.find(pattern); at != std::string::npos; at = line.find(pattern, at + 1))
+        if (at == 0 || line[at - 1] == '{' || line[at - 1] == ',')   // a key, not text inside a value
+            return line.c_str() + at + pattern.size();
+    return nullptr;
+}
+
+static std::string json_string(const std::string& line, const char* key)
+{
+    const char* p = find_value(line, key);
+    if (!p || *p != '"')
+        return {};
+
+    std::string value;
+    for (++p; *p && *p != '"'; ++p)
+    {
+        if (*p == '\\' && p[1])
+        {
+            ++p;
+            if (*p == 'u' && std::strlen(p) >= 5)   // only control characters are \u-escaped
+            {
+                value += char(std::strtol(std::string(p + 1, 4).c_str(), nullptr, 16));
+                p += 4;
+                continue;
+            }
+        }
+        value += *p;
+    }
+    return value;
+}
+
+static std::vector<double> json_numbers(const std::string& line, const char* key)
+{
+    std::vector<double> values;
+    const char*         p = find_value(line, key);
+    if (!p || *p != '[')
+        return values;
+
+    for (++p; *p && *p != ']';)
+    {
+        char*  end;
+        double value = std::strtod(p, &end);
+        if (end == p)
+            break;
+        values.push_back(value);
+        p = end;
+        if (*p == ',')
+            ++p;
+    }
+    return values;
+}
+
+struct t_RunInfo
+{
+    std::string suite, commit, host, cpu, kernel, compiler, flags;
+};
+
+struct t_ResultSet
+{
+    std::vector<t_RunInfo>                         runs;
+    std::map<std::string, std::vector<std::vector<double>>> samples;   // "suite/name" → samples of each run
+    std::vector<std::string>                       order;     // first-seen order, for the report
+};
+
+static bool load_results(const char* path, t_ResultSet& set)
+{
+    std::FILE* file = std::fopen(path, "r");
+    if (!file)
+    {
+        std::perror(path);
+        return false;
+    }
+
+    std::string line;
+    char        chunk[4096];
+    while (std::fgets(chunk, sizeof(chunk), file))
+    {
+        line += chunk;
+        if (line.back() != '\n' && !std::feof(file))
+            continue;   // a long samples array: keep reading the same line
+
+        std::string type = json_string(line, "type");
+        if (type == "run")
+        {
+            set.runs.push_back({ json_string(line, "suite"), json_string(line, "commit"), json_string(line, "host"),
+                                 json_string(line, "cpu"), json_string(line, "kernel"),
+                                 json_string(line, "compiler"), json_string(line, "flags") });
+        }
+        else if (type == "result")
+        {
+            std::string         key     = json_string(line, "suite") + "/" + json_string(line, "name");
+            std::vector<double> samples = json_numbers(line, "samples_ns");
+            auto [entry, inserted]      = set.samples.try_emplace(key);
+            if (inserted)
+                set.order.push_back(key);
+            if (!samples.empty())
+                entry->second.push_back(std::move(samples));
+        }
+        line.clear();
+    }
+    std::fclose(file);
+    return true;
+}
+
+// ---------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------
+static double median_of(std::vector<double> values)
+{
+    std::size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + std::ptrdiff_t(middle), values.end());
+    double upper = values[middle];
+    if (values.size() % 2)
+        return upper;
+    return (upper + *std::max_element(values.begin(), values.begin() + std::ptrdiff_t(middle))) / 2.0;
+}
+
+// Two-sided Mann-Whitney U test, normal approximation with tie and continuity
+// correction — accurate from about 8 samples per side, and the harness takes 31
+static double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b)
+{
+    std::vector<std::pair<double, int>> all;   // value, group (0 = a, 1 = b)
+    for (double v : a)
+        all.push_back({ v, 0 });
+    for (double v : b)
+        all.push_back({ v, 1 });
+    std::sort(all.begin(), all.end());
+
+    const double n1 = double(a.size()), n2 = double(b.size()), n = n1 + n2;
+    double       rank_sum_a = 0, tie_term = 0;
+    for (std::size_t i = 0; i < all.size();)
+    {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first)
+            j++;
+        double average_rank = double(i + j + 1) / 2.0;   // ranks i+1 … j
+        double ties         = double(j - i);
+        tie_term += ties * ties * ties - ties;
+        for (std::size_t k = i; k < j; k++)
+            if (all[k].second == 0)
+                rank_sum_a += average_rank;
+        i = j;
+    }
+
+    double u     = rank_sum_a - n1 * (n1 + 1) / 2.0;
+    double mean  = n1 * n2 / 2.0;
+    double sigma = std::sqrt(n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))));
+    if (sigma == 0)
+        return 1.0;
+    double z = (std::fabs(u - mean) - 0.5) / sigma;
+    return std::erfc(std::max(z, 0.0) / std::sqrt(2.0));
+}
+
+using t_Runs = std::vector<std::vector<double>>;
+
+static std::vector<double> pooled(const t_Runs& runs)
+{
+    std::vector<double> all;
+    for (const std::vector<double>& run : runs)
+        all.insert(all.end(), run.begin(), run.end());
+    return all;
+}
+
+struct t_Bootstrap
+{
+    double low, high;   // percentile interval of the ratio
+    double p_value;     // two-sided: how often the resampled ratio lands across 1.0
+};
+
+// Hierarchical percentile bootstrap of median(candidate) / median(baseline): each
+// round draws as many runs as there are, with replacement, and then each drawn
+// run's samples with replacement. With one run per side it is the plain bootstrap.
+// 10000 rounds resolve p-values down to 2e-4, enough for Holm over 40 benchmarks
+static t_Bootstrap bootstrap_ratio(const t_Runs& baseline, const t_Runs& candidate, double confidence,
+                                   int rounds = 10000)
+{
+    std::mt19937_64     rng(12345);   // fixed: the same files always give the same report
+    std::vector<double> ratios, resample;
+    ratios.reserve(std::size_t(rounds));
+
+    auto resampled_median = [&](const t_Runs& runs)
+    {
+        resample.clear();
+        for (std::size_t r = 0; r < runs.size(); r++)
+        {
+            const std::vector<double>& run = runs[rng() % runs.size()];
+            for (std::size_t i = 0; i < run.size(); i++)
+                resample.push_back(run[rng() % run.size()]);
+        }
+        return median_of(resample);
+    };
+
+    std::size_t below = 0, above = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        double base  = resampled_median(baseline);
+        double ratio = base > 0 ? resampled_median(candidate) / base : 1.0;
+        below += ratio <= 1.0;
+        above += ratio >= 1.0;
+        ratios.push_back(ratio);
+    }
+
+    std::sort(ratios.begin(), ratios.end());
+    double      tail  = (1.0 - confidence) / 2.0;
+    std::size_t lower = std::size_t(tail * double(rounds - 1));
+    std::size_t upper = std::size_t((1.0 - tail) * double(rounds - 1));
+    double      p     = std::min(1.0, 2.0 * double(std::min(below, above) + 1) / double(rounds + 1));
+    return { ratios[lower], ratios[upper], p };
+}
+
+// ---------------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------------
+struct t_Comparison
+{
+    std::string name;
+    std::size_t baseline_runs, candidate_runs;
+    double      baseline_median, candidate_median;
+    double      ratio, ratio_low, ratio_high;
+    double      p_value, p_adjusted;
+    const char* verdict;
+};
+
+// Holm-Bonferroni step-down: the k-th smallest of m p-values is multiplied by
+// (m - k), and adjusted values are kept monotone
+static void adjust_holm(std::vector<t_Comparison>& comparisons)
+{
+    std::vector<t_Comparison*> sorted;
+    for (t_Comparison& c : comparisons)
+        sorted.push_back(&c);
+    std::sort(sorted.begin(), sorted.end(), [](const t_Comparison* a, const t_Comparison* b) {
+        return a->p_value < b->p_value;
+    });
+
+    double running_max = 0;
+    for (std::size_t k = 0; k < sorted.size(); k++)
+    {
+        double adjusted = std::min(1.0, double(sorted.size() - k) * sorted[k]->p_value);
+        running_max     = std::max(running_max, adjusted);
+        sorted[k]->p_adjusted = running_max;
+    }
+}
+
+static void warn_if_different(const char* what, const std::string& a, const std::string& b)
+{
+    if (a != b)
+        std::printf("warning: %s differs\n  baseline : %s\n  candidate: %s\n", what, a.c_str(), b.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    double      alpha      = 0.01;
+    double      min_change = 0.01;
+    const char* paths[2]   = {};
+    int         path_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--alpha=", 8) == 0)
+            alpha = std::atof(argv[i] + 8);
+        else if (std::strncmp(argv[i], "--min-change=", 13) == 0)
+            min_change = std::atof(argv[i] + 13);
+        else if (argv[i][0] != '-' && path_count < 2)
+            paths[path_count++] = argv[i];
+        else
+            path_count = 3;   // unknown option or too many files
+    }
+    if (path_count != 2 || alpha <= 0 || alpha >= 1)
+    {
+        std::fprintf(stderr, "usage: %s baseline.jsonl candidate.jsonl [--alpha=0.01] [--min-change=0.01]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    t_ResultSet baseline, candidate;
+    if (!load_results(paths[0], baseline) || !load_results(paths[1], candidate))
+        return 2;
+    if (baseline.runs.empty() || candidate.runs.empty())
+    {
+        std::fprintf(stderr, "no runs found — were the files written with --json?\n");
+        return 2;
+    }
+
+    const t_RunInfo& base_run = baseline.runs.front();
+    const t_RunInfo& cand_run = candidate.runs.front();
+    std::printf("baseline : %s (%s)\ncandidate: %s (%s)\n", base_run.commit.c_str(), paths[0],
+                cand_run.commit.c_str(), paths[1]);
+    warn_if_different("host", base_run.host, cand_run.host);
+    warn_if_different("CPU", base_run.cpu, cand_run.cpu);
+    warn_if_different("kernel", base_run.kernel, cand_run.kernel);
+    warn_if_different("compiler", base_run.compiler, cand_run.compiler);
+    warn_if_different("flags", base_run.flags, cand_run.flags);
+
+    std::vector<t_Comparison> comparisons;
+    bool                      single_run = false;
+    for (const std::string& name : baseline.order)
+    {
+        auto other = candidate.samples.find(name);
+        if (other == candidate.samples.end())
+            continue;
+        const t_Runs&       runs_a = baseline.samples[name];
+        const t_Runs&       runs_b = other->second;
+        std::vector<double> a      = pooled(runs_a);
+        std::vector<double> b      = pooled(runs_b);
+        if (a.size() < 2 || b.size() < 2)
+            continue;
+
+        t_Comparison c{};
+        c.name             = name;
+        c.baseline_runs    = runs_a.size();
+        c.candidate_runs   = runs_b.size();
+        c.baseline_median  = median_of(a);
+        c.candidate_median = median_of(b);
+        c.ratio            = c.baseline_median > 0 ? c.candidate_median / c.baseline_median : 1.0;
+
+        t_Bootstrap bootstrap = bootstrap_ratio(runs_a, runs_b, 1.0 - alpha);
+        c.ratio_low           = bootstrap.low;
+        c.ratio_high          = bootstrap.high;
+        if (runs_a.size() >= 2 && runs_b.size() >= 2)
+            c.p_value = bootstrap.p_value;
+        else
+        {
+            c.p_value  = mann_whitney_p(a, b);   // nothing to resample runs from
+            single_run = true;
+        }
+        comparisons.push_back(c);
+    }
+    if (comparisons.empty())
+    {
+        std::fprintf(stderr, "no benchmark appears in both files\n");
+        return 2;
+    }
+    adjust_holm(comparisons);
+    if (single_run)
+        std::printf("warning: a single run on one side — its samples are treated as independent and run-to-run\n"
+                    "         variation is not measured; append several runs per side (compare-commits.sh ROUNDS)\n");
+
+    int slower = 0, faster = 0;
+    std::printf("\n%-44s %11s %11s %8s %19s %9s  %s\n", "benchmark (median ns)", "baseline", "candidate", "change",
+                "CI of change", "p (Holm)", "verdict");
+    for (t_Comparison& c : comparisons)
+    {
+        bool significant = c.p_adjusted < alpha && std::fabs(c.ratio - 1.0) >= min_change;
+        if (significant && c.ratio_low > 1.0)
+            c.verdict = "SLOWER", slower++;
+        else if (significant && c.ratio_high < 1.0)
+            c.verdict = "faster", faster++;
+        else
+            c.verdict = "~";
+
+        char interval[32];
+        std::snprintf(interval, sizeof(interval), "[%+.1f%%, %+.1f%%]", 100.0 * (c.ratio_low - 1.0),
+                      100.0 * (c.ratio_high - 1.0));
+        std::printf("%-44s %11.2f %11.2f %+7.1f%% %19s %9.2g  %s\n", c.name.c_str(), c.baseline_median,
+                    c.candidate_median, 100.0 * (c.ratio - 1.0), interval, c.p_adjusted, c.verdict);
+    }
+
+    std::printf("\n%zu compared, %d slower, %d faster (α = %g, %g%% CI", comparisons.size(), slower, faster, alpha,
+                100.0 * (1.0 - alpha));
+    if (min_change > 0)
+        std::printf(", ignoring changes under %g%%", 100.0 * min_change);
+    std::printf(")\n");
+    return slower ? 1 : 0;
+}
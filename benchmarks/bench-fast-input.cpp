@@ -0,0 +1,238 @@
+// Parsing a large file of numbers — cin >>, scanf, getline + stoll, FastScanner
+//
+// Generates a text file (1 GiB by default, reused if it already exists with the right
+// size) of random signed integers, several per line, or of doubles with --floats.
+// Each method parses the whole file once, from the page cache: the first pass
+// (unmeasured) reads it in, so the numbers are parsing cost, not disk speed.
+//
+// Every method must produce the same checksum, or the run is reported as wrong.
+//
+// Compile: g++ -std=c++20 -O2 bench-fast-input.cpp -o bench-fast-input
+//          (add -mavx2 for the 32-byte separator skip)
+// Run    : ./bench-fast-input [--size-mb=1024] [--file=/tmp/bench-fast-input.txt] [--floats]
+
+#include "../tips/fast-scanner.hpp"
+#include "../tips/fast-writer.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct t_InputOptions
+{
+    std::string   path    = "/tmp/bench-fast-input.txt";
+    std::uint64_t size_mb = 1024;
+    bool          floats  = false;
+};
+
+// ---------------------------------------------------------------
+// Input file
+// ---------------------------------------------------------------
+static bool generate_file(const t_InputOptions& options)
+{
+    const std::uint64_t target = options.size_mb << 20;
+    struct stat         info;
+    if (::stat(options.path.c_str(), &info) == 0 && std::uint64_t(info.st_size) >= target
+        && std::uint64_t(info.st_size) < target + 4096)
+        return true;   // left over from an earlier run
+
+    int fd = ::open(options.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::perror(options.path.c_str());
+        return false;
+    }
+    std::printf("generating %s (%" PRIu64 " MiB)…\n", options.path.c_str(), options.size_mb);
+    std::fflush(stdout);
+
+    // Magnitudes spread over 1 to 10 digits, like IDs, counters and prices mixed
+    std::mt19937_64 rng(2024);
+    FastWriter      out(fd);
+    std::uint64_t   written = 0;
+    for (std::uint64_t n = 0; written < target; n++)
+    {
+        std::uint64_t digits    = 1 + rng() % 10;
+        std::int64_t  magnitude = std::int64_t(rng() % std::uint64_t(std::pow(10.0, double(digits))));
+        std::int64_t  value     = rng() & 1 ? -magnitude : magnitude;
+        char          separator = n % 8 == 7 ? '\n' : ' ';
+
+        char* begin = out.reserve(40);
+        char* p     = begin;
+        if (options.floats)
+            p = std::to_chars(p, p + 39, double(value) / 1000.0).ptr;
+        else
+            p = std::to_chars(p, p + 39, value).ptr;
+        *p++ = separator;
+        out.commit(p);
+        written += std::uint64_t(p - begin);
+    }
+    out << '\n';
+    bool ok = out.flush();
+    ::close(fd);
+    return ok;
+}
+
+// ---------------------------------------------------------------
+// Methods — each returns the sum of all values (wrapping for integers)
+// ---------------------------------------------------------------
+template<typename T>
+struct t_Parsed
+{
+    T             sum   = 0;
+    std::uint64_t count = 0;
+
+    void add(T value)
+    {
+        if constexpr (std::is_integral_v<T>)
+            sum = T(std::uint64_t(sum) + std::uint64_t(value));
+        else
+            sum += value;
+        count++;
+    }
+};
+
+template<typename T>
+static t_Parsed<T> parse_scanf(const char* path)
+{
+    t_Parsed<T> parsed;
+    std::FILE*  file = std::fopen(path, "r");
+    T           value;
+    if constexpr (std::is_integral_v<T>)
+        while (std::fscanf(file, "%" SCNd64, &value) == 1)
+            parsed.add(value);
+    else
+        while (std::fscanf(file, "%lf", &value) == 1)
+            parsed.add(value);
+    std::fclose(file);
+    return parsed;
+}
+
+// An ifstream is never synchronized with stdio: this is cin >> after sync_with_stdio(false)
+template<typename T>
+static t_Parsed<T> parse_stream(const char* path)
+{
+    t_Parsed<T>   parsed;
+    std::ifstream in(path);
+    T             value;
+    while (in >> value)
+        parsed.add(value);
+    return parsed;
+}
+
+// One std::string per line, one per token: the common "read a line, then split" code
+template<typename T>
+static t_Parsed<T> parse_getline(const char* path)
+{
+    t_Parsed<T>   parsed;
+    std::ifstream in(path);
+    std::string   line;
+    while (std::getline(in, line))
+    {
+        std::size_t position = 0;
+        while (position < line.size())
+        {
+            std::size_t start = line.find_first_not_of(' ', position);
+            if (start == std::string::npos)
+                break;
+            std::size_t stop = line.find(' ', start);
+            std::string token = line.substr(start, stop - start);
+            if constexpr (std::is_integral_v<T>)
+                parsed.add(std::stoll(token));
+            else
+                parsed.add(std::stod(token));
+            position = stop;
+        }
+    }
+    return parsed;
+}
+
+template<typename T>
+static t_Parsed<T> parse_fast(const char* path, FastScanner::Source source)
+{
+    t_Parsed<T> parsed;
+    FastScanner in(path, source);
+    T           value;
+    while (in.read(value))
+        parsed.add(value);
+    if (in.failed())
+        std::fprintf(stderr, "FastScanner: parse error\n");
+    return parsed;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+template<typename T, typename Parse>
+static void measure(const char* name, double megabytes, const t_Parsed<T>& expected, Parse parse)
+{
+    auto        start   = std::chrono::steady_clock::now();
+    t_Parsed<T> parsed  = parse();
+    double      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool same = parsed.count == expected.count
+                && (std::is_integral_v<T> ? parsed.sum == expected.sum
+                                          : std::fabs(double(parsed.sum - expected.sum)) <= 1e-6 * std::fabs(double(expected.sum)));
+    std::printf("%-28s %8.2f s %9.1f MB/s %8.1f ns/value  %s\n", name, seconds, megabytes / seconds,
+                seconds * 1e9 / double(parsed.count ? parsed.count : 1), same ? "" : "WRONG RESULT");
+    std::fflush(stdout);
+}
+
+template<typename T>
+static void run_all(const t_InputOptions& options)
+{
+    const char* path = options.path.c_str();
+    struct stat info;
+    ::stat(path, &info);
+    double megabytes = double(info.st_size) / 1e6;
+
+    // Warm the page cache and get the reference result
+    t_Parsed<T> expected = parse_fast<T>(path, FastScanner::READ);
+    std::printf("%" PRIu64 " %s, %.0f MB\n\n", expected.count, std::is_integral_v<T> ? "integers" : "doubles",
+                megabytes);
+
+    measure("scanf", megabytes, expected, [&] { return parse_scanf<T>(path); });
+    measure("ifstream >> (unsynced cin)", megabytes, expected, [&] { return parse_stream<T>(path); });
+    measure("getline + stoll/stod", megabytes, expected, [&] { return parse_getline<T>(path); });
+    measure("FastScanner, read(2)", megabytes, expected, [&] { return parse_fast<T>(path, FastScanner::READ); });
+    measure("FastScanner, mmap", megabytes, expected, [&] { return parse_fast<T>(path, FastScanner::MAP); });
+}
+
+int main(int argc, char** argv)
+{
+    t_InputOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--size-mb=", 10) == 0)
+            options.size_mb = std::strtoull(argv[i] + 10, nullptr, 10);
+        else if (std::strncmp(argv[i], "--file=", 7) == 0)
+            options.path = argv[i] + 7;
+        else if (std::strcmp(argv[i], "--floats") == 0)
+            options.floats = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--size-mb=1024] [--file=path] [--floats]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.floats && options.path == "/tmp/bench-fast-input.txt")
+        options.path = "/tmp/bench-fast-input-floats.txt";
+
+    if (!generate_file(options))
+        return 1;
+    if (options.floats)
+        run_all<double>(options);
+    else
+        run_all<std::int64_t>(options);
+    return 0;
+}
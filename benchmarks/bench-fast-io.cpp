@@ -0,0 +1,217 @@
+// Measured claims from tips/fast-io.cpp — cost of writing one integer line
+// (plus FastWriter from tips/fast-writer.hpp, the option when cout is not fast enough)
+//
+// stdout is redirected to /dev/null while the benchmarks run, so the numbers are the
+// formatting + buffering cost, not the terminal's. The report goes to the original
+// stdout.
+//
+// sync_with_stdio(false) can't be undone, so the synced benchmarks must run first —
+// they are registered first, and the unsynced ones switch it off on first use.
+//
+// --bulk[=N] skips the per-line benchmarks and writes N integers (default 100 million)
+// once with each method, reporting the total time and throughput.
+//
+// Compile: g++ -std=c++20 -O2 bench-fast-io.cpp -o bench-fast-io
+// Run    : ./bench-fast-io [--cpu=0]
+//          ./bench-fast-io --bulk
+
+#include "benchmark.hpp"
+#include "../tips/fast-writer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+BENCHMARK(printf_int)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::printf("%d\n", int(it));
+}
+
+BENCHMARK(cout_synced_newline)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::cout << int(it) << '\n';
+}
+
+// std::endl flushes: one write() system call per line
+BENCHMARK(cout_synced_endl)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::cout << int(it) << std::endl;
+}
+
+static void unsync_stdio_once()
+{
+    static bool s_done = [] {
+        std::cout.flush();
+        std::fflush(stdout);
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+        return true;
+    }();
+    (void)s_done;
+}
+
+BENCHMARK(cout_unsynced_newline)
+{
+    unsync_stdio_once();
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::cout << int(it) << '\n';
+}
+
+BENCHMARK(cout_unsynced_endl)
+{
+    unsync_stdio_once();
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::cout << int(it) << std::endl;
+}
+
+// An ofstream never synchronizes with stdio — the ceiling for iostream formatting
+BENCHMARK(ofstream_newline)
+{
+    static std::ofstream s_null("/dev/null");
+    for (std::uint64_t it = 0; it < iterations; it++)
+        s_null << int(it) << '\n';
+}
+
+static FastWriter& fast_writer()
+{
+    static FastWriter s_out(STDOUT_FILENO);
+    return s_out;
+}
+
+BENCHMARK(fast_writer_newline)
+{
+    FastWriter& out = fast_writer();
+    for (std::uint64_t it = 0; it < iterations; it++)
+        out << int(it) << '\n';
+}
+
+// The same buffer, formatting with std::to_chars instead of the digit-pair table
+BENCHMARK(fast_writer_to_chars)
+{
+    FastWriter& out = fast_writer();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        char* p = out.reserve(16);
+        p       = std::to_chars(p, p + 15, int(it)).ptr;
+        *p++    = '\n';
+        out.commit(p);
+    }
+}
+
+BENCHMARK(fast_writer_double)
+{
+    FastWriter& out = fast_writer();
+    for (std::uint64_t it = 0; it < iterations; it++)
+        out << double(it) * 0.001 << '\n';
+}
+
+BENCHMARK(printf_double)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        std::printf("%.17g\n", double(it) * 0.001);
+}
+
+// ---------------------------------------------------------------
+// --bulk: one pass of N lines per method, like a log dump
+// ---------------------------------------------------------------
+template<typename Body>
+static void time_bulk(std::FILE* report, const char* name, std::uint64_t count, Body body)
+{
+    auto   start   = std::chrono::steady_clock::now();
+    body();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(report, "%-34s %9.2f s %9.1f M lines/s %9.1f ns/line\n", name, seconds,
+                 double(count) / seconds / 1e6, seconds * 1e9 / double(count));
+    std::fflush(report);
+}
+
+static void run_bulk(std::FILE* report, std::uint64_t count)
+{
+    std::fprintf(report, "writing %llu integers to /dev/null, one per line\n", (unsigned long long)count);
+
+    time_bulk(report, "printf", count, [&] {
+        for (std::uint64_t i = 0; i < count; i++)
+            std::printf("%llu\n", (unsigned long long)i);
+        std::fflush(stdout);
+    });
+
+    unsync_stdio_once();
+    time_bulk(report, "cout, sync_with_stdio(false)", count, [&] {
+        for (std::uint64_t i = 0; i < count; i++)
+            std::cout << i << '\n';
+        std::cout.flush();
+    });
+
+    time_bulk(report, "FastWriter (digit pairs)", count, [&] {
+        FastWriter out(STDOUT_FILENO);
+        for (std::uint64_t i = 0; i < count; i++)
+            out << i << '\n';
+    });
+
+    time_bulk(report, "FastWriter (std::to_chars)", count, [&] {
+        FastWriter out(STDOUT_FILENO);
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            char* p = out.reserve(24);
+            p       = std::to_chars(p, p + 23, i).ptr;
+            *p++    = '\n';
+            out.commit(p);
+        }
+    });
+}
+
+int main(int argc, char** argv)
+{
+    // --bulk is this program's own option; the rest go to the harness
+    std::uint64_t bulk_count = 0;
+    int           kept       = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--bulk") == 0)
+            bulk_count = 100'000'000;
+        else if (std::strncmp(argv[i], "--bulk=", 7) == 0)
+            bulk_count = std::strtoull(argv[i] + 7, nullptr, 10);
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    t_BenchOptions options;
+    if (!parse_benchmark_options(argc, argv, options))
+        return 1;
+
+    // Keep the real stdout for the report, then point fd 1 at /dev/null
+    std::fflush(stdout);
+    int report_fd = dup(STDOUT_FILENO);
+    int null_fd   = open("/dev/null", O_WRONLY);
+    if (report_fd < 0 || null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0)
+    {
+        std::perror("redirecting stdout");
+        return 1;
+    }
+    close(null_fd);
+
+    options.out = fdopen(report_fd, "w");
+    int result  = 0;
+    if (bulk_count)
+    {
+        if (options.cpu >= 0)
+            pin_to_cpu(options.cpu);
+        run_bulk(options.out, bulk_count);
+    }
+    else
+        result = run_benchmarks(options);
+    fast_writer().flush();
+
+    std::cout.flush();
+    std::fflush(stdout);
+    std::fclose(options.out);
+    return result;
+}
@@ -0,0 +1,246 @@
+// Reading a multi-GB text file — the approaches from tips/file-handling.md vs MappedFile
+//
+// Every method does the same light work on the data — count lines and bytes and add
+// up the first byte of each line — so what is measured is how the bytes get to the
+// program. Two scenarios from the guide:
+//
+//   whole file   istreambuf_iterator, rdbuf() into a stringstream, pre-sized read(),
+//                MappedFile (with and without MAP_POPULATE)
+//   line by line getline into a std::string, MappedFile::lines()
+//
+// Warm (default): the file is in the page cache, as right after writing it.
+// --cold: before each method the file's pages are dropped with posix_fadvise(DONTNEED),
+//         so readahead and MAP_POPULATE matter. Needs no root, but the file must not be
+//         mapped or dirty elsewhere.
+//
+// Compile: g++ -std=c++20 -O2 bench-file-read.cpp -o bench-file-read
+// Run    : ./bench-file-read [--size-mb=2048] [--file=/tmp/bench-file-read.txt] [--cold]
+
+#include "../tips/fast-writer.hpp"
+#include "../tips/mapped-file.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct t_ReadOptions
+{
+    std::string   path    = "/tmp/bench-file-read.txt";
+    std::uint64_t size_mb = 2048;
+    bool          cold    = false;
+};
+
+struct t_Digest
+{
+    std::uint64_t lines = 0;
+    std::uint64_t bytes = 0;   // without the '\n's
+    std::uint64_t first = 0;   // sum of the first byte of every non-empty line
+
+    bool operator==(const t_Digest&) const = default;
+};
+
+// ---------------------------------------------------------------
+// Input file: log-like lines of 20 to 200 characters
+// ---------------------------------------------------------------
+static bool generate_file(const t_ReadOptions& options)
+{
+    const std::uint64_t target = options.size_mb << 20;
+    struct stat         info;
+    if (::stat(options.path.c_str(), &info) == 0 && std::uint64_t(info.st_size) >= target
+        && std::uint64_t(info.st_size) < target + 4096)
+        return true;
+
+    int fd = ::open(options.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::perror(options.path.c_str());
+        return false;
+    }
+    std::printf("generating %s (%" PRIu64 " MiB)…\n", options.path.c_str(), options.size_mb);
+    std::fflush(stdout);
+
+    static const char words[] = "INFO request served user session cache miss hit latency queue worker "
+                                "shard replica timeout retry commit flush segment index ";
+    std::mt19937_64 rng(7);
+    FastWriter      out(fd);
+    std::uint64_t   written = 0;
+    for (std::uint64_t n = 0; written < target; n++)
+    {
+        std::size_t length = 20 + rng() % 181;
+        char*       line   = out.reserve(length + 1);
+        for (std::size_t i = 0; i < length; i++)
+            line[i] = words[(n * 31 + i * 7 + (rng() & 15)) % (sizeof(words) - 1)];
+        line[length] = '\n';
+        out.commit(line + length + 1);
+        written += length + 1;
+    }
+    bool ok = out.flush();
+    ::close(fd);
+    return ok;
+}
+
+static void drop_from_page_cache(const char* path)
+{
+    int fd = ::open(path, O_RDONLY);
+    if (fd >= 0)
+    {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+// ---------------------------------------------------------------
+// Whole file
+// ---------------------------------------------------------------
+static t_Digest digest_text(std::string_view text)
+{
+    t_Digest digest;
+    for (std::string_view line : t_LineRange(text.data(), text.data() + text.size()))
+    {
+        digest.lines++;
+        digest.bytes += line.size();
+        if (!line.empty())
+            digest.first += static_cast<unsigned char>(line[0]);
+    }
+    return digest;
+}
+
+// file-handling.md "Method 1: Using iterators"
+static t_Digest whole_istreambuf_iterator(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return digest_text(content);
+}
+
+// "Method 2: Using stringstream" — the text exists twice before str() returns
+static t_Digest whole_stringstream(const char* path)
+{
+    std::ifstream     file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return digest_text(buffer.str());
+}
+
+// "Method 3: Pre-allocate with file size"
+static t_Digest whole_presized_read(const char* path)
+{
+    std::ifstream   file(path, std::ios::binary | std::ios::ate);
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::string content(std::size_t(size), '\0');
+    file.read(&content[0], size);
+    return digest_text(content);
+}
+
+static t_Digest whole_mapped(const char* path, t_MapOptions options)
+{
+    MappedFile file(path, options);
+    return digest_text(file.text());
+}
+
+// ---------------------------------------------------------------
+// Line by line
+// ---------------------------------------------------------------
+static t_Digest lines_getline(const char* path)
+{
+    t_Digest      digest;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);)
+    {
+        digest.lines++;
+        digest.bytes += line.size();
+        if (!line.empty())
+            digest.first += static_cast<unsigned char>(line[0]);
+    }
+    return digest;
+}
+
+static t_Digest lines_mapped(const char* path)
+{
+    t_Digest   digest;
+    MappedFile file(path);
+    for (std::string_view line : file.lines())
+    {
+        digest.lines++;
+        digest.bytes += line.size();
+        if (!line.empty())
+            digest.first += static_cast<unsigned char>(line[0]);
+    }
+    return digest;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+template<typename Method>
+static void measure(const char* name, const t_ReadOptions& options, const t_Digest& expected, Method method)
+{
+    if (options.cold)
+        drop_from_page_cache(options.path.c_str());
+
+    auto     start   = std::chrono::steady_clock::now();
+    t_Digest digest  = method(options.path.c_str());
+    double   seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double megabytes = double(expected.bytes + expected.lines) / 1e6;
+    std::printf("  %-36s %7.2f s %8.0f MB/s  %s\n", name, seconds, megabytes / seconds,
+                digest == expected ? "" : "WRONG RESULT");
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    t_ReadOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--size-mb=", 10) == 0)
+            options.size_mb = std::strtoull(argv[i] + 10, nullptr, 10);
+        else if (std::strncmp(argv[i], "--file=", 7) == 0)
+            options.path = argv[i] + 7;
+        else if (std::strcmp(argv[i], "--cold") == 0)
+            options.cold = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--size-mb=2048] [--file=path] [--cold]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!generate_file(options))
+        return 1;
+
+    // Reference result, and the page cache warmed for the warm runs
+    t_Digest expected = whole_mapped(options.path.c_str(), { t_Access::Sequential, true });
+    std::printf("%" PRIu64 " lines, %.0f MB, %s page cache\n\n", expected.lines,
+                double(expected.bytes + expected.lines) / 1e6, options.cold ? "cold" : "warm");
+
+    std::printf("whole file\n");
+    measure("istreambuf_iterator", options, expected, whole_istreambuf_iterator);
+    if (options.size_mb <= 1024)
+        measure("stringstream << rdbuf()", options, expected, whole_stringstream);
+    else
+        std::printf("  %-36s skipped: holds two copies of the file\n", "stringstream << rdbuf()");
+    measure("pre-sized string + read()", options, expected, whole_presized_read);
+    measure("MappedFile (sequential)", options, expected,
+            [](const char* path) { return whole_mapped(path, { t_Access::Sequential, false }); });
+    measure("MappedFile (random)", options, expected,
+            [](const char* path) { return whole_mapped(path, { t_Access::Random, false }); });
+    measure("MappedFile (MAP_POPULATE)", options, expected,
+            [](const char* path) { return whole_mapped(path, { t_Access::Sequential, true }); });
+
+    std::printf("line by line\n");
+    measure("getline into std::string", options, expected, lines_getline);
+    measure("MappedFile::lines()", options, expected, lines_mapped);
+    return 0;
+}
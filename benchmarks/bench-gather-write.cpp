@@ -0,0 +1,306 @@
+// Batched log output — concatenate-then-write vs writev of the fragments in place
+//
+// Writes the same stream of log records (512 MB by default) to a file, each record a
+// freshly formatted header (~40 bytes) and a body that already exists in memory (60 to
+// 400 bytes, like a message received from a producer). Methods:
+//
+//   ostringstream batch    file-handling.md "Batch Writes": accumulate, str(), ofstream
+//   std::string batch      append into a reserved string, write(2) at 1 MiB
+//   FastWriter             copy into a 1 MiB buffer (tips/fast-writer.hpp)
+//   writev per record      header + body in place, one system call per record
+//   GatherWriter           header copied, body referenced unless under 512 bytes,
+//                          writev at 1 MiB / IOV_MAX ("no copies": bodies always referenced)
+//   GatherWriter + 1 ms    the same with a latency bound
+//
+// Reported per MB written: write/writev system calls (from /proc/self/io) and bytes
+// copied in user space before the kernel's own copy — counted by the method's code,
+// not including copies inside the standard library (ofstream may add one more).
+//
+// Every method must produce the same file (size and checksum). --large switches to
+// bodies of 2 to 16 KB: fewer, bigger fragments, where skipping the copy pays off.
+//
+// Compile: g++ -std=c++20 -O2 bench-gather-write.cpp -o bench-gather-write
+// Run    : ./bench-gather-write [--size-mb=512] [--file=/tmp/bench-gather.log] [--large]
+
+#include "../tips/fast-writer.hpp"
+#include "../tips/gather-writer.hpp"
+#include "../tips/mapped-file.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct t_GatherOptions
+{
+    std::string   path    = "/tmp/bench-gather.log";
+    std::uint64_t size_mb = 512;
+    bool          large   = false;   // bodies of 2 to 16 KB instead of 60 to 400 bytes
+};
+
+// ---------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------
+struct t_Records
+{
+    std::vector<std::string> bodies;   // each ends with '\n'
+    std::vector<std::uint32_t> order;  // body of record i
+    std::uint64_t            total = 0;
+};
+
+static t_Records make_records(std::uint64_t target, bool large)
+{
+    static const char words[] = "request served user session cache miss hit latency queue worker shard replica "
+                                "timeout retry commit flush segment index upstream ";
+    std::mt19937_64 rng(17);
+    t_Records       records;
+    for (int i = 0; i < 1024; i++)
+    {
+        std::string body;
+        std::size_t length = large ? 2048 + rng() % 14337 : 60 + rng() % 341;
+        for (std::size_t j = 0; j < length; j++)
+            body += words[(i * 13 + j * 5 + (rng() & 7)) % (sizeof(words) - 1)];
+        body += '\n';
+        records.bodies.push_back(std::move(body));
+    }
+    char header[64];
+    while (records.total < target)
+    {
+        std::uint32_t body = std::uint32_t(rng() % records.bodies.size());
+        records.order.push_back(body);
+        records.total += std::uint64_t(std::snprintf(header, sizeof(header), "2024-05-01T12:00:00.%09" PRIu64 " INFO ",
+                                                     std::uint64_t(records.order.size())))
+                         + records.bodies[body].size();
+    }
+    return records;
+}
+
+// "2024-05-01T12:00:00.<9-digit sequence> INFO " — the same bytes for every method
+static std::size_t format_header(char* out, std::uint64_t sequence)
+{
+    static const char prefix[] = "2024-05-01T12:00:00.";
+    std::memcpy(out, prefix, sizeof(prefix) - 1);
+    char* p = out + sizeof(prefix) - 1;
+    for (int i = 8; i >= 0; i--, sequence /= 10)
+        p[i] = char('0' + sequence % 10);
+    std::memcpy(p + 9, " INFO ", 6);
+    return std::size_t(p + 15 - out);
+}
+
+// ---------------------------------------------------------------
+// Methods — each returns the bytes it copied in user space
+// ---------------------------------------------------------------
+static std::uint64_t ostringstream_batch(const t_Records& records, int, const char* path)
+{
+    std::ofstream      file(path, std::ios::binary | std::ios::trunc);
+    std::ostringstream buffer;
+    std::uint64_t      copied = 0;
+    char               header[64];
+    for (std::size_t i = 0; i < records.order.size(); i++)
+    {
+        std::size_t        length = format_header(header, i + 1);
+        const std::string& body   = records.bodies[records.order[i]];
+        buffer.write(header, std::streamsize(length));
+        buffer << body;
+        copied += length + body.size();
+        if (buffer.tellp() >= (1 << 20))
+        {
+            std::string batch = buffer.str();   // the whole batch once more
+            copied += batch.size();
+            file << batch;
+            buffer.str(std::string());
+        }
+    }
+    std::string batch = buffer.str();
+    copied += batch.size();
+    file << batch;
+    return copied;
+}
+
+static std::uint64_t string_batch(const t_Records& records, int fd, const char*)
+{
+    std::string   batch;
+    std::uint64_t copied = 0;
+    batch.reserve((1 << 20) + 512);
+    char header[64];
+    for (std::size_t i = 0; i < records.order.size(); i++)
+    {
+        std::size_t        length = format_header(header, i + 1);
+        const std::string& body   = records.bodies[records.order[i]];
+        batch.append(header, length);
+        batch += body;
+        copied += length + body.size();
+        if (batch.size() >= (1 << 20))
+        {
+            if (::write(fd, batch.data(), batch.size()) < 0)
+                std::perror("write");
+            batch.clear();
+        }
+    }
+    if (::write(fd, batch.data(), batch.size()) < 0)
+        std::perror("write");
+    return copied;
+}
+
+static std::uint64_t fast_writer(const t_Records& records, int fd, const char*)
+{
+    FastWriter    out(fd);
+    std::uint64_t copied = 0;
+    for (std::size_t i = 0; i < records.order.size(); i++)
+    {
+        char*              header = out.reserve(64);
+        std::size_t        length = format_header(header, i + 1);
+        out.commit(header + length);
+        const std::string& body = records.bodies[records.order[i]];
+        out.write(body);
+        copied += length + body.size();
+    }
+    out.flush();
+    return copied;
+}
+
+static std::uint64_t writev_per_record(const t_Records& records, int fd, const char*)
+{
+    char header[64];
+    for (std::size_t i = 0; i < records.order.size(); i++)
+    {
+        const std::string& body = records.bodies[records.order[i]];
+        iovec              parts[2] = { { header, format_header(header, i + 1) },
+                                        { const_cast<char*>(body.data()), body.size() } };
+        if (::writev(fd, parts, 2) < 0)
+            std::perror("writev");
+    }
+    return 0;
+}
+
+static std::uint64_t gather_writer(const t_Records& records, int fd, t_GatherPolicy policy)
+{
+    GatherWriter out(fd, policy);
+    for (std::size_t i = 0; i < records.order.size(); i++)
+    {
+        char* header = out.reserve(64);
+        out.commit(header + format_header(header, i + 1));
+        out.append(records.bodies[records.order[i]]);
+    }
+    out.flush();
+    return out.statistics().bytes_copied;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+static std::uint64_t read_write_syscalls()
+{
+    std::FILE*    file  = std::fopen("/proc/self/io", "r");
+    std::uint64_t count = 0;
+    char          line[128];
+    while (file && std::fgets(line, sizeof(line), file))
+        if (std::strncmp(line, "syscw:", 6) == 0)
+            count = std::strtoull(line + 6, nullptr, 10);
+    if (file)
+        std::fclose(file);
+    return count;
+}
+
+static std::uint64_t file_checksum(const char* path)
+{
+    MappedFile    file(path);
+    std::uint64_t hash = file.length();
+    const char*   p    = file.text().data();
+    std::size_t   i    = 0;
+    for (; i + 8 <= file.length(); i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ull;
+    }
+    for (; i < file.length(); i++)
+        hash = (hash ^ static_cast<unsigned char>(p[i])) * 0x100000001B3ull;
+    return hash;
+}
+
+template<typename Method>
+static void measure(const char* name, const t_Records& records, const t_GatherOptions& options,
+                    std::uint64_t& reference, Method method)
+{
+    const char* path = options.path.c_str();
+    int         fd   = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        std::perror(path);
+        return;
+    }
+
+    std::uint64_t syscalls = read_write_syscalls();
+    auto          start    = std::chrono::steady_clock::now();
+    std::uint64_t copied   = method(records, fd, path);
+    double        seconds  = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    syscalls               = read_write_syscalls() - syscalls;
+    ::close(fd);
+
+    std::uint64_t checksum = file_checksum(path);
+    if (!reference)
+        reference = checksum;
+    double megabytes = double(records.total) / 1e6;
+    std::printf("  %-24s %7.3f s %7.0f MB/s %10.1f syscalls/MB %8.0f KB copied/MB  %s\n", name, seconds,
+                megabytes / seconds, double(syscalls) / megabytes, double(copied) / 1e3 / megabytes,
+                checksum == reference ? "" : "WRONG RESULT");
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    t_GatherOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--size-mb=", 10) == 0)
+            options.size_mb = std::strtoull(argv[i] + 10, nullptr, 10);
+        else if (std::strncmp(argv[i], "--file=", 7) == 0)
+            options.path = argv[i] + 7;
+        else if (std::strcmp(argv[i], "--large") == 0)
+            options.large = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--size-mb=512] [--file=path] [--large]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    t_Records records = make_records(options.size_mb << 20, options.large);
+    std::printf("%zu records, %.0f MB to %s\n\n", records.order.size(), double(records.total) / 1e6,
+                options.path.c_str());
+
+    std::uint64_t reference = 0;
+    measure("ostringstream batch", records, options, reference, ostringstream_batch);
+    measure("std::string batch", records, options, reference, string_batch);
+    measure("FastWriter", records, options, reference, fast_writer);
+    measure("writev per record", records, options, reference, writev_per_record);
+    measure("GatherWriter, no copies", records, options, reference,
+            [](const t_Records& r, int fd, const char*)
+            {
+                t_GatherPolicy policy;
+                policy.copy_below = 0;
+                return gather_writer(r, fd, policy);
+            });
+    measure("GatherWriter", records, options, reference,
+            [](const t_Records& r, int fd, const char*) { return gather_writer(r, fd, {}); });
+    measure("GatherWriter + 1 ms", records, options, reference,
+            [](const t_Records& r, int fd, const char*)
+            {
+                t_GatherPolicy policy;
+                policy.max_delay = std::chrono::milliseconds(1);
+                return gather_writer(r, fd, policy);
+            });
+    ::unlink(options.path.c_str());
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Measured claims from tips/loop-optimizations.md
+//
+// Compile: g++ -std=c++20 -O2 bench-loops.cpp -o bench-loops
+// Run    : ./bench-loops [--cpu=0] [--filter=sum]
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+static constexpr std::size_t N = 1 << 16;   // 256 KiB of floats — stays in L2
+
+static std::vector<float>& input_a()
+{
+    static std::vector<float> s_data = [] {
+        std::vector<float> data(N);
+        for (std::size_t i = 0; i < N; i++)
+            data[i] = float(i % 100) * 0.5f;
+        return data;
+    }();
+    return s_data;
+}
+
+static std::vector<float>& input_b()
+{
+    static std::vector<float> s_data(input_a().rbegin(), input_a().rend());
+    return s_data;
+}
+
+// ---------------------------------------------------------------
+// "std::vector traversal: identical with -O2" — four ways to sum a vector.
+// Integer sums, so the compiler may vectorize all of them (float sums cannot be
+// reordered without -ffast-math, which would hide the comparison).
+// ---------------------------------------------------------------
+static std::vector<int>& input_ints()
+{
+    static std::vector<int> s_data = [] {
+        std::vector<int> data(N);
+        std::iota(data.begin(), data.end(), 0);
+        return data;
+    }();
+    return s_data;
+}
+
+BENCHMARK(sum_raw_index)
+{
+    const std::vector<int>& data = input_ints();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int sum = 0;
+        for (std::size_t i = 0; i < data.size(); ++i)
+            sum += data[i];
+        do_not_optimize(sum);
+    }
+}
+
+BENCHMARK(sum_range_for)
+{
+    const std::vector<int>& data = input_ints();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int sum = 0;
+        for (int x : data)
+            sum += x;
+        do_not_optimize(sum);
+    }
+}
+
+BENCHMARK(sum_std_for_each)
+{
+    const std::vector<int>& data = input_ints();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int sum = 0;
+        std::for_each(data.begin(), data.end(), [&sum](int x) { sum += x; });
+        do_not_optimize(sum);
+    }
+}
+
+BENCHMARK(sum_ranges_for_each)
+{
+    const std::vector<int>& data = input_ints();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int sum = 0;
+        std::ranges::for_each(data, [&sum](int x) { sum += x; });
+        do_not_optimize(sum);
+    }
+}
+
+// ---------------------------------------------------------------
+// "Raw array, float math: best auto-vectorization" — and what __restrict__ adds
+// ---------------------------------------------------------------
+__attribute__((noinline)) static void add_arrays(const float* a, const float* b, float* c, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        c[i] = a[i] + b[i];
+}
+
+__attribute__((noinline)) static void add_no_alias(const float* __restrict__ a, const float* __restrict__ b,
+                                                   float* __restrict__ c, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        c[i] = a[i] + b[i];
+}
+
+BENCHMARK(add_arrays_raw)
+{
+    static std::vector<float> s_out(N);
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        add_arrays(input_a().data(), input_b().data(), s_out.data(), N);
+        clobber_memory();
+    }
+}
+
+BENCHMARK(add_arrays_restrict)
+{
+    static std::vector<float> s_out(N);
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        add_no_alias(input_a().data(), input_b().data(), s_out.data(), N);
+        clobber_memory();
+    }
+}
+
+BENCHMARK(add_arrays_std_transform)
+{
+    static std::vector<float> s_out(N);
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::transform(input_a().begin(), input_a().end(), input_b().begin(), s_out.begin(), std::plus<>());
+        clobber_memory();
+    }
+}
+
+// ---------------------------------------------------------------
+// "Memory access patterns beat loop syntax" — the same sum over a list
+// ---------------------------------------------------------------
+BENCHMARK(sum_std_list)
+{
+    static std::list<int> s_list(input_ints().begin(), input_ints().end());
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int sum = 0;
+        for (int x : s_list)
+            sum += x;
+        do_not_optimize(sum);
+    }
+}
+
+// ---------------------------------------------------------------
+// "Expensive end-condition recalculation" — strlen in the loop condition
+// ---------------------------------------------------------------
+static char* text_buffer()
+{
+    static char s_text[4096];
+    if (!s_text[0])
+        std::memset(s_text, 'a', sizeof(s_text) - 1);
+    return s_text;
+}
+
+BENCHMARK(count_chars_strlen_in_condition)
+{
+    char* text = text_buffer();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int count = 0;
+        for (std::size_t i = 0; i < std::strlen(text); ++i)
+        {
+            count += text[i] == 'a';
+            clobber_memory();   // as if process(text[i]) could modify the buffer
+        }
+        do_not_optimize(count);
+    }
+}
+
+BENCHMARK(count_chars_strlen_cached)
+{
+    char* text = text_buffer();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        int count = 0;
+        const std::size_t len = std::strlen(text);
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            count += text[i] == 'a';
+            clobber_memory();
+        }
+        do_not_optimize(count);
+    }
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,323 @@
+// Binary data on disk — ifstream::read into vectors vs RecordFile read in place
+//
+// 20M trades (id, timestamp, price, quantity, symbol) stored three ways:
+//
+//   structs   file-handling.md write_vector_binary(): a count, then the raw structs;
+//             read back with read_vector_binary() — ifstream::read into a vector
+//   columns   one such file per column, so a query reads only the columns it needs
+//   record    tips/record-file.hpp: one file, aligned columns, mmap'd and used in place
+//
+// Two queries: notional = Σ price × quantity (2 of 5 columns) and a digest over every
+// column. Timings include opening/reading the files. "record + verify" adds the full
+// checksum pass that an untrusted file would get.
+//
+// --cold drops the files from the page cache before every measurement.
+//
+// Compile: g++ -std=c++20 -O2 bench-record-file.cpp -o bench-record-file
+// Run    : ./bench-record-file [--rows=20000000] [--dir=/tmp] [--cold]
+
+#include "../tips/record-file.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+struct t_RecordOptions
+{
+    std::string   directory = "/tmp";
+    std::uint64_t rows      = 20'000'000;
+    bool          cold      = false;
+};
+
+struct t_Trade
+{
+    std::int64_t id;
+    std::int64_t timestamp;
+    double       price;
+    std::int32_t quantity;
+    char         symbol[12];   // NUL-padded
+};
+
+struct t_Result
+{
+    double        notional = 0;
+    std::uint64_t digest   = 0;
+
+    bool operator==(const t_Result&) const = default;
+};
+
+// ---------------------------------------------------------------
+// The guide's raw binary helpers
+// ---------------------------------------------------------------
+template<typename T>
+static void write_vector_binary(const std::string& filename, const std::vector<T>& vec)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    std::ofstream file(filename, std::ios::binary);
+    std::size_t   size = vec.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(vec.data()), std::streamsize(vec.size() * sizeof(T)));
+}
+
+template<typename T>
+static std::vector<T> read_vector_binary(const std::string& filename)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    std::ifstream file(filename, std::ios::binary);
+    std::size_t   size = 0;
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::vector<T> vec(size);
+    file.read(reinterpret_cast<char*>(vec.data()), std::streamsize(size * sizeof(T)));
+    return vec;
+}
+
+// ---------------------------------------------------------------
+// Data set, written in all three formats
+// ---------------------------------------------------------------
+struct t_Files
+{
+    std::string structs, id, timestamp, price, quantity, symbol, record;
+
+    explicit t_Files(const std::string& directory)
+        : structs(directory + "/bench-trades.bin"), id(directory + "/bench-trades.id"),
+          timestamp(directory + "/bench-trades.timestamp"), price(directory + "/bench-trades.price"),
+          quantity(directory + "/bench-trades.quantity"), symbol(directory + "/bench-trades.symbol"),
+          record(directory + "/bench-trades.rec")
+    {
+    }
+
+    std::vector<const std::string*> all() const { return { &structs, &id, &timestamp, &price, &quantity, &symbol, &record }; }
+};
+
+static void generate(const t_RecordOptions& options, const t_Files& files)
+{
+    static const char* const symbols[] = { "AAPL", "MSFT", "GOOG", "AMZN", "NVDA", "META", "TSLA", "BRK.B", "JPM", "V" };
+    std::mt19937_64          rng(99);
+
+    std::vector<t_Trade>      trades(options.rows);
+    std::vector<std::int64_t> ids(options.rows), timestamps(options.rows);
+    std::vector<double>       prices(options.rows);
+    std::vector<std::int32_t> quantities(options.rows);
+    std::vector<std::string>  names(options.rows);
+    std::vector<char>         fixed_names(options.rows * sizeof(t_Trade::symbol), '\0');   // the "columns" variant
+    for (std::uint64_t i = 0; i < options.rows; i++)
+    {
+        std::uint64_t r = rng();
+        t_Trade&      t = trades[i];
+        std::memset(&t, 0, sizeof(t));
+        t.id        = std::int64_t(i);
+        t.timestamp = 1'700'000'000'000'000 + std::int64_t(i * 1000 + r % 1000);
+        t.price     = 10.0 + double(r >> 40) / 16384.0;
+        t.quantity  = std::int32_t(1 + (r >> 8) % 500);
+        std::strcpy(t.symbol, symbols[r % 10]);
+
+        ids[i]        = t.id;
+        timestamps[i] = t.timestamp;
+        prices[i]     = t.price;
+        quantities[i] = t.quantity;
+        names[i]      = t.symbol;
+        std::memcpy(&fixed_names[i * sizeof(t.symbol)], t.symbol, sizeof(t.symbol));
+    }
+
+    write_vector_binary(files.structs, trades);
+    write_vector_binary(files.id, ids);
+    write_vector_binary(files.timestamp, timestamps);
+    write_vector_binary(files.price, prices);
+    write_vector_binary(files.quantity, quantities);
+    write_vector_binary(files.symbol, fixed_names);
+
+    RecordFileWriter writer;
+    writer.add_column("id", ids);
+    writer.add_column("timestamp", timestamps);
+    writer.add_column("price", prices);
+    writer.add_column("quantity", quantities);
+    writer.add_strings("symbol", names);
+    writer.write(files.record);
+}
+
+static void drop_from_page_cache(const t_Files& files)
+{
+    for (const std::string* path : files.all())
+    {
+        int fd = ::open(path->c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------
+static void mix(std::uint64_t& digest, std::uint64_t value) { digest = (digest ^ value) * 0x100000001B3ull; }
+
+static std::uint64_t symbol_hash(std::string_view symbol)
+{
+    std::uint64_t hash = 0;
+    for (char c : symbol)
+        hash = hash * 31 + static_cast<unsigned char>(c);
+    return hash;
+}
+
+static t_Result structs_notional(const t_Files& files)
+{
+    t_Result result;
+    for (const t_Trade& t : read_vector_binary<t_Trade>(files.structs))
+        result.notional += t.price * t.quantity;
+    return result;
+}
+
+static t_Result structs_all(const t_Files& files)
+{
+    t_Result result;
+    for (const t_Trade& t : read_vector_binary<t_Trade>(files.structs))
+    {
+        result.notional += t.price * t.quantity;
+        mix(result.digest, std::uint64_t(t.id ^ t.timestamp) + symbol_hash(t.symbol));
+    }
+    return result;
+}
+
+static t_Result columns_notional(const t_Files& files)
+{
+    t_Result                  result;
+    std::vector<double>       price    = read_vector_binary<double>(files.price);
+    std::vector<std::int32_t> quantity = read_vector_binary<std::int32_t>(files.quantity);
+    for (std::size_t i = 0; i < price.size(); i++)
+        result.notional += price[i] * quantity[i];
+    return result;
+}
+
+static t_Result columns_all(const t_Files& files)
+{
+    t_Result                  result;
+    std::vector<std::int64_t> id        = read_vector_binary<std::int64_t>(files.id);
+    std::vector<std::int64_t> timestamp = read_vector_binary<std::int64_t>(files.timestamp);
+    std::vector<double>       price     = read_vector_binary<double>(files.price);
+    std::vector<std::int32_t> quantity  = read_vector_binary<std::int32_t>(files.quantity);
+    std::vector<char>         symbol    = read_vector_binary<char>(files.symbol);
+    for (std::size_t i = 0; i < price.size(); i++)
+    {
+        result.notional += price[i] * quantity[i];
+        mix(result.digest, std::uint64_t(id[i] ^ timestamp[i]) + symbol_hash(&symbol[i * sizeof(t_Trade::symbol)]));
+    }
+    return result;
+}
+
+static t_Result record_notional(const t_Files& files, bool verify)
+{
+    t_Result   result;
+    RecordFile file(files.record);
+    if (verify && !file.verify().empty())
+        return result;
+    std::span<const double>       price    = file.column<double>("price");
+    std::span<const std::int32_t> quantity = file.column<std::int32_t>("quantity");
+    for (std::size_t i = 0; i < price.size(); i++)
+        result.notional += price[i] * quantity[i];
+    return result;
+}
+
+static t_Result record_all(const t_Files& files, bool verify)
+{
+    t_Result   result;
+    RecordFile file(files.record);
+    if (verify && !file.verify().empty())
+        return result;
+    std::span<const std::int64_t> id        = file.column<std::int64_t>("id");
+    std::span<const std::int64_t> timestamp = file.column<std::int64_t>("timestamp");
+    std::span<const double>       price     = file.column<double>("price");
+    std::span<const std::int32_t> quantity  = file.column<std::int32_t>("quantity");
+    t_StringColumn                symbol    = file.strings("symbol");
+    for (std::size_t i = 0; i < price.size(); i++)
+    {
+        result.notional += price[i] * quantity[i];
+        mix(result.digest, std::uint64_t(id[i] ^ timestamp[i]) + symbol_hash(symbol[i]));
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+template<typename Query>
+static void measure(const char* name, const t_Files& files, const t_RecordOptions& options, const t_Result& expected,
+                    Query query)
+{
+    if (options.cold)
+        drop_from_page_cache(files);
+
+    auto     start   = std::chrono::steady_clock::now();
+    t_Result result  = query(files);
+    double   seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("  %-28s %8.1f ms  %s\n", name, seconds * 1e3, result == expected ? "" : "WRONG RESULT");
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    t_RecordOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--rows=", 7) == 0)
+            options.rows = std::strtoull(argv[i] + 7, nullptr, 10);
+        else if (std::strncmp(argv[i], "--dir=", 6) == 0)
+            options.directory = argv[i] + 6;
+        else if (std::strcmp(argv[i], "--cold") == 0)
+            options.cold = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--rows=20000000] [--dir=/tmp] [--cold]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    t_Files files(options.directory);
+    try
+    {
+        generate(options, files);
+    }
+    catch (const std::exception& error)
+    {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    auto opened = std::chrono::steady_clock::now();
+    {
+        RecordFile file(files.record);
+        std::printf("%" PRIu64 " rows; RecordFile opens and validates in %.1f us\n", file.rows(),
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - opened).count());
+        std::printf("%s page cache\n", options.cold ? "cold" : "warm");
+    }
+
+    t_Result notional = columns_notional(files);
+    std::printf("\nnotional (price, quantity)\n");
+    measure("structs, ifstream::read", files, options, notional, structs_notional);
+    measure("columns, ifstream::read", files, options, notional, columns_notional);
+    measure("record, in place", files, options, notional, [](const t_Files& f) { return record_notional(f, false); });
+    measure("record + verify()", files, options, notional, [](const t_Files& f) { return record_notional(f, true); });
+
+    t_Result all = columns_all(files);
+    std::printf("\nall five columns\n");
+    measure("structs, ifstream::read", files, options, all, structs_all);
+    measure("columns, ifstream::read", files, options, all, columns_all);
+    measure("record, in place", files, options, all, [](const t_Files& f) { return record_all(f, false); });
+    measure("record + verify()", files, options, all, [](const t_Files& f) { return record_all(f, true); });
+
+    for (const std::string* path : files.all())
+        ::unlink(path->c_str());
+    return 0;
+}
@@ -0,0 +1,282 @@
+// Splitting lines and CSV fields — getline + stringstream vs find() vs the SIMD scanner
+//
+// Two in-memory texts (256 MB each by default), so only splitting is measured:
+//
+//   plain   numbers and words, no quotes: every method must agree
+//           - file-handling.md "Reading with Custom Delimiter": getline + stringstream
+//           - string-optimization.md split(): find() into std::strings
+//           - the same with string_views
+//           - split_lines + split_fields (tips/delimiter-scanner.hpp)
+//   quoted  one field in ten quoted, with commas, doubled quotes and line breaks inside
+//           - getline + stringstream, for reference (it splits quoted fields apart)
+//           - a per-character state machine, the usual scalar CSV parser
+//           - CsvReader
+//
+// Every method reports rows, fields and field bytes; a mismatch with the reference is
+// reported as wrong.
+//
+// Compile: g++ -std=c++20 -O2 bench-split.cpp -o bench-split
+//          (add -mavx2 -mpclmul for 32-byte compares and the carry-less prefix XOR)
+// Run    : ./bench-split [--size-mb=256]
+
+#include "../tips/delimiter-scanner.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct t_SplitDigest
+{
+    std::uint64_t rows   = 0;
+    std::uint64_t fields = 0;
+    std::uint64_t bytes  = 0;
+
+    bool operator==(const t_SplitDigest&) const = default;
+};
+
+// ---------------------------------------------------------------
+// Input texts
+// ---------------------------------------------------------------
+static std::string generate_text(std::size_t size, bool quoted)
+{
+    static const char* const words[] = { "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta" };
+    std::mt19937_64          rng(quoted ? 5 : 3);
+    std::string              text;
+    text.reserve(size + 256);
+    while (text.size() < size)
+    {
+        int columns = 6 + int(rng() % 6);
+        for (int column = 0; column < columns; column++)
+        {
+            if (column)
+                text += ',';
+            std::uint64_t r = rng();
+            if (quoted && r % 10 == 0)
+            {
+                text += '"';
+                text += words[(r >> 8) & 7];
+                text += (r >> 12) & 1 ? ", " : " \"\"quoted\"\" ";
+                if (((r >> 13) & 15) == 0)
+                    text += "\nsecond line";
+                text += words[(r >> 16) & 7];
+                text += '"';
+            }
+            else if (r & 1)
+                text += std::to_string((r >> 20) % 1000000);
+            else
+                text += words[(r >> 8) & 7];
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+// ---------------------------------------------------------------
+// Methods
+// ---------------------------------------------------------------
+static t_SplitDigest getline_stringstream(const std::string& text)
+{
+    t_SplitDigest      digest;
+    std::istringstream input(text);
+    for (std::string line; std::getline(input, line);)
+    {
+        std::vector<std::string> row;
+        std::stringstream        ss(line);
+        for (std::string cell; std::getline(ss, cell, ',');)
+            row.push_back(std::move(cell));
+
+        digest.rows++;
+        digest.fields += row.size();
+        for (const std::string& cell : row)
+            digest.bytes += cell.size();
+    }
+    return digest;
+}
+
+// The guide's split(), applied to lines found the same way
+static std::vector<std::string> split(std::string_view str, char delimiter)
+{
+    std::vector<std::string> tokens;
+    std::size_t              start = 0;
+    std::size_t              end   = str.find(delimiter);
+    while (end != std::string_view::npos)
+    {
+        tokens.emplace_back(str.substr(start, end - start));
+        start = end + 1;
+        end   = str.find(delimiter, start);
+    }
+    tokens.emplace_back(str.substr(start));
+    return tokens;
+}
+
+static t_SplitDigest find_strings(const std::string& text)
+{
+    t_SplitDigest    digest;
+    std::string_view rest = text;
+    while (!rest.empty())
+    {
+        std::size_t newline = rest.find('\n');
+        std::size_t length  = newline == std::string_view::npos ? rest.size() : newline;
+        std::vector<std::string> row = split(rest.substr(0, length), ',');
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+
+        digest.rows++;
+        digest.fields += row.size();
+        for (const std::string& cell : row)
+            digest.bytes += cell.size();
+    }
+    return digest;
+}
+
+static t_SplitDigest find_views(const std::string& text)
+{
+    t_SplitDigest                 digest;
+    std::vector<std::string_view> row;
+    std::string_view              rest = text;
+    while (!rest.empty())
+    {
+        std::size_t      newline = rest.find('\n');
+        std::string_view line    = rest.substr(0, newline);
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+
+        row.clear();
+        for (std::size_t comma; (comma = line.find(',')) != std::string_view::npos; line.remove_prefix(comma + 1))
+            row.push_back(line.substr(0, comma));
+        row.push_back(line);
+
+        digest.rows++;
+        digest.fields += row.size();
+        for (std::string_view cell : row)
+            digest.bytes += cell.size();
+    }
+    return digest;
+}
+
+static t_SplitDigest simd_split(const std::string& text)
+{
+    t_SplitDigest digest;
+    for (std::string_view line : split_lines(text))
+    {
+        digest.rows++;
+        for (std::string_view cell : split_fields(line, ','))
+        {
+            digest.fields++;
+            digest.bytes += cell.size();
+        }
+    }
+    return digest;
+}
+
+// One branchy step per character — what a CSV parser without SIMD looks like
+static t_SplitDigest scalar_csv(const std::string& text)
+{
+    t_SplitDigest digest;
+    const char*   p           = text.data();
+    const char*   end         = p + text.size();
+    const char*   field_start = p;
+    bool          in_quotes   = false;
+    bool          row_open    = false;
+
+    auto add_field = [&](const char* stop)
+    {
+        if (stop - field_start >= 2 && *field_start == '"' && stop[-1] == '"')
+            digest.bytes += std::uint64_t(stop - field_start - 2);
+        else
+            digest.bytes += std::uint64_t(stop - field_start);
+        digest.fields++;
+    };
+
+    for (; p < end; ++p)
+    {
+        row_open = true;
+        char c   = *p;
+        if (c == '"')
+            in_quotes = !in_quotes;
+        else if (!in_quotes && (c == ',' || c == '\n'))
+        {
+            add_field(p);
+            field_start = p + 1;
+            if (c == '\n')
+            {
+                digest.rows++;
+                row_open = false;
+            }
+        }
+    }
+    if (row_open)
+    {
+        add_field(end);
+        digest.rows++;
+    }
+    return digest;
+}
+
+static t_SplitDigest simd_csv(const std::string& text)
+{
+    t_SplitDigest                 digest;
+    CsvReader                     csv(text);
+    std::vector<std::string_view> row;
+    while (csv.next_row(row))
+    {
+        digest.rows++;
+        digest.fields += row.size();
+        for (std::string_view cell : row)
+            digest.bytes += cell.size();
+    }
+    return digest;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+template<typename Method>
+static void measure(const char* name, const std::string& text, const t_SplitDigest* expected, Method method)
+{
+    auto          start   = std::chrono::steady_clock::now();
+    t_SplitDigest digest  = method(text);
+    double        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const char* verdict = !expected ? "(splits inside quotes)" : digest == *expected ? "" : "WRONG RESULT";
+    std::printf("  %-34s %7.3f s %7.2f GB/s  %s\n", name, seconds, double(text.size()) / 1e9 / seconds, verdict);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t size_mb = 256;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--size-mb=", 10) == 0)
+            size_mb = std::strtoull(argv[i] + 10, nullptr, 10);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--size-mb=256]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::string   plain    = generate_text(size_mb << 20, false);
+    t_SplitDigest expected = find_views(plain);
+    std::printf("plain: %" PRIu64 " rows, %" PRIu64 " fields, %.0f MB\n", expected.rows, expected.fields,
+                double(plain.size()) / 1e6);
+    measure("getline + stringstream", plain, &expected, getline_stringstream);
+    measure("find() into std::strings", plain, &expected, find_strings);
+    measure("find() into string_views", plain, &expected, find_views);
+    measure("split_lines + split_fields", plain, &expected, simd_split);
+    plain = std::string();
+
+    std::string quoted = generate_text(size_mb << 20, true);
+    expected           = scalar_csv(quoted);
+    std::printf("\nquoted: %" PRIu64 " rows, %" PRIu64 " fields, %.0f MB\n", expected.rows, expected.fields,
+                double(quoted.size()) / 1e6);
+    measure("getline + stringstream", quoted, nullptr, getline_stringstream);
+    measure("per-character state machine", quoted, &expected, scalar_csv);
+    measure("CsvReader", quoted, &expected, simd_csv);
+    return 0;
+}
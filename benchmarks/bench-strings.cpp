@@ -0,0 +1,203 @@
+// Measured claims from tips/string-optimization.md ("Performance Tips")
+//
+// Compile: g++ -std=c++20 -O2 bench-strings.cpp -o bench-strings
+// Run    : ./bench-strings [--cpu=0] [--filter=reserve]
+
+#include "benchmark.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static const std::string& long_text()
+{
+    static const std::string s_text(200, 'x');   // well past SSO: copies allocate
+    return s_text;
+}
+
+// ---------------------------------------------------------------
+// 1. "Use string_view for parameters" — by value vs const& vs string_view
+// The callees do almost nothing, so what is measured is the cost of passing.
+// ---------------------------------------------------------------
+__attribute__((noinline)) static std::size_t peek_by_value(std::string text)
+{
+    return text.size() + std::size_t(text.back());
+}
+
+__attribute__((noinline)) static std::size_t peek_by_ref(const std::string& text)
+{
+    return text.size() + std::size_t(text.back());
+}
+
+__attribute__((noinline)) static std::size_t peek_by_view(std::string_view text)
+{
+    return text.size() + std::size_t(text.back());
+}
+
+BENCHMARK(param_string_by_value)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        do_not_optimize(peek_by_value(long_text()));
+}
+
+BENCHMARK(param_const_string_ref)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        do_not_optimize(peek_by_ref(long_text()));
+}
+
+BENCHMARK(param_string_view)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        do_not_optimize(peek_by_view(long_text()));
+}
+
+// A string literal argument: const std::string& must build a temporary, string_view doesn't
+BENCHMARK(param_literal_to_const_ref)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        do_not_optimize(peek_by_ref("a literal long enough to need a heap allocation, xxxxxxxx"));
+}
+
+BENCHMARK(param_literal_to_string_view)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+        do_not_optimize(peek_by_view("a literal long enough to need a heap allocation, xxxxxxxx"));
+}
+
+// ---------------------------------------------------------------
+// 2. "Reserve capacity" — 1000 appends
+// ---------------------------------------------------------------
+BENCHMARK(append_1000_no_reserve)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::string result;
+        for (int i = 0; i < 1000; ++i)
+            result += 'x';
+        do_not_optimize(result.data());
+    }
+}
+
+BENCHMARK(append_1000_reserved)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::string result;
+        result.reserve(1000);
+        for (int i = 0; i < 1000; ++i)
+            result += 'x';
+        do_not_optimize(result.data());
+    }
+}
+
+// ---------------------------------------------------------------
+// 3. "Use move semantics" — returning and handing over a large string
+// ---------------------------------------------------------------
+BENCHMARK(large_string_copy)
+{
+    static std::string s_source(1'000'000, 'x');
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::string copy = s_source;
+        do_not_optimize(copy.data());
+    }
+}
+
+BENCHMARK(large_string_move)
+{
+    static std::string s_source(1'000'000, 'x');
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::string moved = std::move(s_source);
+        do_not_optimize(moved.data());
+        s_source = std::move(moved);   // hand it back for the next iteration
+    }
+}
+
+// ---------------------------------------------------------------
+// 4. ".size() not strlen()" — O(1) vs O(n)
+// ---------------------------------------------------------------
+BENCHMARK(length_strlen)
+{
+    const std::string& text = long_text();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        const char* data = text.c_str();
+        do_not_optimize(data);   // hide that the length is already known
+        do_not_optimize(std::strlen(data));
+    }
+}
+
+BENCHMARK(length_size)
+{
+    const std::string& text = long_text();
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        const std::string* str = &text;
+        do_not_optimize(str);
+        do_not_optimize(str->size());
+    }
+}
+
+// ---------------------------------------------------------------
+// Common patterns — building "Name: <name>, Age: <n>"
+// ---------------------------------------------------------------
+BENCHMARK(build_ostringstream)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::ostringstream oss;
+        oss << "Name: " << "Alice" << ", Age: " << int(it & 127);
+        std::string result = oss.str();
+        do_not_optimize(result.data());
+    }
+}
+
+BENCHMARK(build_append_to_string)
+{
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::string result;
+        result.reserve(32);
+        result += "Name: ";
+        result += "Alice";
+        result += ", Age: ";
+        result += std::to_string(int(it & 127));
+        do_not_optimize(result.data());
+    }
+}
+
+// Splitting with string_view — the guide's split() copies every token into a std::string
+BENCHMARK(split_to_strings)
+{
+    static const std::string s_csv = "alpha,beta,gamma,delta,epsilon,zeta,eta,theta,iota,kappa";
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        std::vector<std::string> tokens;
+        std::string_view         rest = s_csv;
+        for (std::size_t comma; (comma = rest.find(',')) != std::string_view::npos; rest.remove_prefix(comma + 1))
+            tokens.emplace_back(rest.substr(0, comma));
+        tokens.emplace_back(rest);
+        do_not_optimize(tokens.data());
+    }
+}
+
+BENCHMARK(split_to_views)
+{
+    static const std::string s_csv = "alpha,beta,gamma,delta,epsilon,zeta,eta,theta,iota,kappa";
+    std::vector<std::string_view> tokens;   // reused: no allocation after the first round
+    for (std::uint64_t it = 0; it < iterations; it++)
+    {
+        tokens.clear();
+        std::string_view rest = s_csv;
+        for (std::size_t comma; (comma = rest.find(',')) != std::string_view::npos; rest.remove_prefix(comma + 1))
+            tokens.push_back(rest.substr(0, comma));
+        tokens.push_back(rest);
+        do_not_optimize(tokens.data());
+    }
+}
+
+BENCHMARK_MAIN();
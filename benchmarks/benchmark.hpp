@@ -0,0 +1,480 @@
+// Minimal micro-benchmark harness — header only, no dependencies
+//
+//   #include "benchmark.hpp"
+//
+//   BENCHMARK(sum_raw_loop)              // the body runs with 'iterations' in scope
+//   {
+//       for (std::uint64_t i = 0; i < iterations; i++)
+//           do_not_optimize(sum(data));
+//   }
+//
+//   BENCHMARK_MAIN();
+//
+// For every registered benchmark the harness:
+//
+//   1. warms up (caches, branch predictors, CPU frequency) for --warmup-ms
+//   2. grows 'iterations' until one sample takes at least --sample-ms
+//   3. takes --samples samples and reports ns per iteration as
+//      median, p99, mean ± stddev and min
+//
+// Command line:  --filter=<substring>  --cpu=<n>  --samples=<n>  --sample-ms=<n>
+//                --warmup-ms=<n>  --list  --json=<file>
+//
+// --json appends the run to <file> as JSON lines: one "run" record (suite, commit,
+// machine fingerprint, compiler, flags, date) followed by one "result" record per
+// benchmark with every sample, so bench-compare.cpp can test two runs for significant
+// differences. Build with -DBENCH_COMMIT=\"<sha>\" and -DBENCH_FLAGS=\"<flags>\" to
+// record them (compare-commits.sh does); the BENCH_COMMIT environment variable also
+// works for the commit.
+//
+// Linux only for --cpu (sched_setaffinity) and the machine fingerprint; everything
+// else is portable C++17.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------
+// Optimization barriers
+// ---------------------------------------------------------------
+// Forces 'value' to be computed and kept in a register or memory, so the compiler
+// cannot delete the work that produced it. Costs no instructions of its own.
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sink;
+    s_sink = &value;
+#endif
+}
+
+// Every pending store must be performed before this point and every load after it
+// re-reads memory — stops the compiler from hoisting work out of the timing loop.
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Pin the calling thread to one CPU, so the scheduler can't migrate it mid-sample
+inline bool pin_to_cpu(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------
+using t_BenchFunction = void (*)(std::uint64_t iterations);
+
+struct t_Benchmark
+{
+    const char*     name;
+    t_BenchFunction function;
+};
+
+inline std::vector<t_Benchmark>& benchmark_registry()
+{
+    static std::vector<t_Benchmark> s_registry;
+    return s_registry;
+}
+
+struct t_BenchmarkRegistrar
+{
+    t_BenchmarkRegistrar(const char* name, t_BenchFunction function)
+    {
+        benchmark_registry().push_back({ name, function });
+    }
+};
+
+// Benchmarks run in the order they appear in the file
+#define BENCHMARK(name)                                                          \
+    static void name(std::uint64_t iterations);                                  \
+    static t_BenchmarkRegistrar name##_registrar(#name, name);                   \
+    static void name([[maybe_unused]] std::uint64_t iterations)
+
+#define BENCHMARK_MAIN()                                                         \
+    int main(int argc, char** argv) { return run_benchmarks(argc, argv); }
+
+// ---------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------
+struct t_BenchResult
+{
+    const char*   name;
+    std::uint64_t iterations;   // per sample
+    std::size_t   samples;
+    double        median_ns;    // all values are per iteration
+    double        p99_ns;
+    double        mean_ns;
+    double        stddev_ns;
+    double        min_ns;
+    std::vector<double> sample_ns;   // every sample, sorted
+};
+
+// Linear interpolation between the two closest ranks
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    double      rank  = p * double(sorted.size() - 1);
+    std::size_t lower = std::size_t(rank);
+    std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - double(lower));
+}
+
+inline t_BenchResult summarize(const char* name, std::uint64_t iterations, std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (double s : samples)
+        sum += s;
+    double mean = sum / double(samples.size());
+
+    double squares = 0;
+    for (double s : samples)
+        squares += (s - mean) * (s - mean);
+    double stddev = samples.size() > 1 ? std::sqrt(squares / double(samples.size() - 1)) : 0.0;
+
+    t_BenchResult result{ name, iterations, samples.size(), percentile(samples, 0.5), percentile(samples, 0.99),
+                          mean, stddev, samples.front(), {} };
+    result.sample_ns = std::move(samples);
+    return result;
+}
+
+// ---------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------
+struct t_BenchOptions
+{
+    const char* filter     = nullptr;   // run only names containing this
+    int         cpu        = -1;        // -1 → don't pin
+    int         samples    = 31;
+    double      sample_ms  = 10.0;      // minimum duration of one sample
+    double      warmup_ms  = 100.0;
+    bool        list_only  = false;
+    const char* json_path  = nullptr;   // append results as JSON lines
+    const char* suite      = "benchmarks"; // program name, set from argv[0]
+    std::FILE*  out        = stdout;    // report stream (benchmarks may redirect stdout)
+};
+
+inline double time_once_ns(t_BenchFunction function, std::uint64_t iterations)
+{
+    clobber_memory();
+    auto start = std::chrono::steady_clock::now();
+    function(iterations);
+    auto end = std::chrono::steady_clock::now();
+    clobber_memory();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+inline t_BenchResult run_one(const t_Benchmark& bench, const t_BenchOptions& options)
+{
+    const double sample_ns = options.sample_ms * 1e6;
+
+    // Warm up and calibrate together: grow the iteration count until one call
+    // fills a sample, and keep going until the warmup time is used up as well
+    std::uint64_t iterations = 1;
+    double        warmed_ns  = 0;
+    for (;;)
+    {
+        double elapsed = time_once_ns(bench.function, iterations);
+        warmed_ns += elapsed;
+
+        if (elapsed < sample_ns)
+        {
+            // Aim 20% past the target, but never more than 10× per step
+            double scale = elapsed > 0 ? 1.2 * sample_ns / elapsed : 10.0;
+            iterations   = std::max<std::uint64_t>(iterations + 1,
+                                                   std::uint64_t(double(iterations) * std::min(scale, 10.0)));
+        }
+        else if (warmed_ns >= options.warmup_ms * 1e6)
+        {
+            break;
+        }
+    }
+
+    std::vector<double> samples;
+    samples.reserve(std::size_t(options.samples));
+    for (int s = 0; s < options.samples; s++)
+        samples.push_back(time_once_ns(bench.function, iterations) / double(iterations));
+
+    return summarize(bench.name, iterations, std::move(samples));
+}
+
+inline void print_result(std::FILE* out, const t_BenchResult& r)
+{
+    double spread = r.median_ns > 0 ? 100.0 * r.stddev_ns / r.median_ns : 0.0;
+    std::fprintf(out, "%-40s %12.2f %12.2f %12.2f %7.1f%% %12.2f %12llu\n",
+                 r.name, r.median_ns, r.p99_ns, r.mean_ns, spread, r.min_ns,
+                 (unsigned long long)r.iterations);
+    std::fflush(out);
+}
+
+// ---------------------------------------------------------------
+// JSON lines — what ran, where, and every sample
+// ---------------------------------------------------------------
+inline void write_json_string(std::FILE* file, const char* text)
+{
+    std::fputc('"', file);
+    for (; *text; ++text)
+    {
+        unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\')
+            std::fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            std::fprintf(file, "\\u%04x", c);
+        else
+            std::fputc(c, file);
+    }
+    std::fputc('"', file);
+}
+
+// First "key : value" line of a /proc file, value trimmed; empty if absent
+inline std::string read_proc_field(const char* path, const char* key)
+{
+    std::string value;
+    if (std::FILE* file = std::fopen(path, "r"))
+    {
+        char        line[512];
+        std::size_t key_length = std::strlen(key);
+        while (std::fgets(line, sizeof(line), file))
+        {
+            if (std::strncmp(line, key, key_length) != 0)
+                continue;
+            const char* colon = std::strchr(line, ':');
+            if (!colon)
+                continue;
+            value = colon + 1;
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\n") + 1);
+            break;
+        }
+        std::fclose(file);
+    }
+    return value;
+}
+
+inline std::string read_first_line(const char* path)
+{
+    std::string value;
+    if (std::FILE* file = std::fopen(path, "r"))
+    {
+        char line[256];
+        if (std::fgets(line, sizeof(line), file))
+            value = line;
+        std::fclose(file);
+        value.erase(value.find_last_not_of(" \n") + 1);
+    }
+    return value;
+}
+
+inline const char* compiler_description()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+// The exact command line isn't visible to the program: BENCH_FLAGS when the build
+// passes it, otherwise what the predefined macros reveal
+inline std::string compiler_flags()
+{
+#ifdef BENCH_FLAGS
+    return BENCH_FLAGS;
+#else
+    std::string flags = "-std=c++" + std::to_string(__cplusplus / 100 % 100);
+#if defined(__OPTIMIZE_SIZE__)
+    flags += " -Os";
+#elif defined(__OPTIMIZE__)
+    flags += " -O1+";   // __OPTIMIZE__ does not tell -O1, -O2 and -O3 apart
+#else
+    flags += " -O0";
+#endif
+#ifdef NDEBUG
+    flags += " -DNDEBUG";
+#endif
+#if defined(__AVX512F__)
+    flags += " (avx512f)";
+#elif defined(__AVX2__)
+    flags += " (avx2)";
+#endif
+    return flags;
+#endif
+}
+
+inline std::string benchmark_commit()
+{
+#ifdef BENCH_COMMIT
+    return BENCH_COMMIT;
+#else
+    const char* commit = std::getenv("BENCH_COMMIT");
+    return commit ? commit : "unknown";
+#endif
+}
+
+inline void write_json_run(std::FILE* file, const t_BenchOptions& options)
+{
+    std::string cpu_model, kernel, host, governor;
+    long        cpus = 0;
+#ifdef __linux__
+    cpu_model = read_proc_field("/proc/cpuinfo", "model name");
+    governor  = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    cpus      = sysconf(_SC_NPROCESSORS_ONLN);
+    utsname name;
+    if (uname(&name) == 0)
+    {
+        kernel = std::string(name.sysname) + " " + name.release;
+        host   = name.nodename;
+    }
+#endif
+
+    char        date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::fprintf(file, "{\"type\":\"run\",\"suite\":");
+    write_json_string(file, options.suite);
+    std::fprintf(file, ",\"commit\":");
+    write_json_string(file, benchmark_commit().c_str());
+    std::fprintf(file, ",\"date\":\"%s\",\"host\":", date);
+    write_json_string(file, host.c_str());
+    std::fprintf(file, ",\"cpu\":");
+    write_json_string(file, cpu_model.c_str());
+    std::fprintf(file, ",\"cpus\":%ld,\"governor\":", cpus);
+    write_json_string(file, governor.c_str());
+    std::fprintf(file, ",\"kernel\":");
+    write_json_string(file, kernel.c_str());
+    std::fprintf(file, ",\"compiler\":");
+    write_json_string(file, compiler_description());
+    std::fprintf(file, ",\"flags\":");
+    write_json_string(file, compiler_flags().c_str());
+    std::fprintf(file, ",\"pinned_cpu\":%d,\"sample_ms\":%g}\n", options.cpu, options.sample_ms);
+}
+
+inline void write_json_result(std::FILE* file, const t_BenchOptions& options, const t_BenchResult& r)
+{
+    std::fprintf(file, "{\"type\":\"result\",\"suite\":");
+    write_json_string(file, options.suite);
+    std::fprintf(file, ",\"name\":");
+    write_json_string(file, r.name);
+    std::fprintf(file, ",\"iterations\":%llu,\"median_ns\":%.4f,\"p99_ns\":%.4f,\"mean_ns\":%.4f,"
+                       "\"stddev_ns\":%.4f,\"min_ns\":%.4f,\"samples_ns\":[",
+                 (unsigned long long)r.iterations, r.median_ns, r.p99_ns, r.mean_ns, r.stddev_ns, r.min_ns);
+    for (std::size_t i = 0; i < r.sample_ns.size(); i++)
+        std::fprintf(file, "%s%.4f", i ? "," : "", r.sample_ns[i]);
+    std::fprintf(file, "]}\n");
+}
+
+inline bool parse_benchmark_options(int argc, char** argv, t_BenchOptions& options)
+{
+    if (argc > 0)
+    {
+        const char* slash = std::strrchr(argv[0], '/');
+        options.suite     = slash ? slash + 1 : argv[0];
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0)         options.filter    = arg + 9;
+        else if (std::strncmp(arg, "--cpu=", 6) == 0)       options.cpu       = std::atoi(arg + 6);
+        else if (std::strncmp(arg, "--samples=", 10) == 0)  options.samples   = std::max(1, std::atoi(arg + 10));
+        else if (std::strncmp(arg, "--sample-ms=", 12) == 0) options.sample_ms = std::atof(arg + 12);
+        else if (std::strncmp(arg, "--warmup-ms=", 12) == 0) options.warmup_ms = std::atof(arg + 12);
+        else if (std::strcmp(arg, "--list") == 0)           options.list_only = true;
+        else if (std::strncmp(arg, "--json=", 7) == 0)      options.json_path = arg + 7;
+        else
+        {
+            std::fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int run_benchmarks(const t_BenchOptions& options)
+{
+    if (options.list_only)
+    {
+        for (const t_Benchmark& bench : benchmark_registry())
+            std::fprintf(options.out, "%s\n", bench.name);
+        return 0;
+    }
+
+    if (options.cpu >= 0 && !pin_to_cpu(options.cpu))
+        std::fprintf(stderr, "warning: could not pin to CPU %d, running unpinned\n", options.cpu);
+
+    std::FILE* json = nullptr;
+    if (options.json_path)
+    {
+        json = std::fopen(options.json_path, "a");
+        if (!json)
+        {
+            std::perror(options.json_path);
+            return 1;
+        }
+        write_json_run(json, options);
+    }
+
+    std::fprintf(options.out, "%-40s %12s %12s %12s %8s %12s %12s\n",
+                 "benchmark (ns per iteration)", "median", "p99", "mean", "stddev", "min", "iterations");
+
+    for (const t_Benchmark& bench : benchmark_registry())
+    {
+        if (options.filter && !std::strstr(bench.name, options.filter))
+            continue;
+        t_BenchResult result = run_one(bench, options);
+        print_result(options.out, result);
+        if (json)
+        {
+            write_json_result(json, options, result);
+            std::fflush(json);
+        }
+    }
+    if (json)
+        std::fclose(json);
+    return 0;
+}
+
+inline int run_benchmarks(int argc, char** argv)
+{
+    t_BenchOptions options;
+    if (!parse_benchmark_options(argc, argv, options))
+        return 1;
+    return run_benchmarks(options);
+}
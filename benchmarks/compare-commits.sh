@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+# Build and run the benchmark suites at two commits, then compare them with bench-compare
+#
+#   benchmarks/compare-commits.sh <baseline-rev> <candidate-rev> [suite ...]
+#
+#   suites      default: bench-loops bench-strings bench-fast-io
+#   ROUNDS      runs per suite and commit, interleaved baseline/candidate (default 3):
+#               samples from one run share its memory layout, frequency and noise,
+#               so only several alternating runs show the run-to-run variation;
+#               bench-compare needs at least 2 to test on runs rather than samples
+#   CXX         compiler (default g++)
+#   CXXFLAGS    flags for both builds (default -std=c++20 -O2)
+#   BENCH_ARGS  extra benchmark options, e.g. "--cpu=0 --samples=51"
+#   OUT         where the .jsonl results are kept (default ./bench-results)
+#
+# Both commits are checked out into temporary git worktrees; the working tree is not
+# touched. Both need a benchmark.hpp that knows --json. Exit status is bench-compare's:
+# 1 when a benchmark got significantly slower.
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+    sed -n '2,18p' "$0" | sed 's/^# \{0,1\}//'
+    exit 2
+fi
+
+baseline_rev=$1
+candidate_rev=$2
+shift 2
+suites=("$@")
+[ ${#suites[@]} -eq 0 ] && suites=(bench-loops bench-strings bench-fast-io)
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++20 -O2}
+ROUNDS=${ROUNDS:-3}
+BENCH_ARGS=${BENCH_ARGS:-}
+OUT=${OUT:-bench-results}
+
+root=$(git rev-parse --show-toplevel)
+work=$(mktemp -d)
+cleanup() {
+    git -C "$root" worktree remove --force "$work/baseline" 2>/dev/null || true
+    git -C "$root" worktree remove --force "$work/candidate" 2>/dev/null || true
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+mkdir -p "$OUT"
+baseline_sha=$(git -C "$root" rev-parse --short "$baseline_rev")
+candidate_sha=$(git -C "$root" rev-parse --short "$candidate_rev")
+baseline_json="$OUT/baseline-$baseline_sha.jsonl"
+candidate_json="$OUT/candidate-$candidate_sha.jsonl"
+rm -f "$baseline_json" "$candidate_json"
+
+# The same binary names on both sides: results are matched by suite (program) name
+build() { # <label> <sha>
+    local label=$1 sha=$2
+    git -C "$root" worktree add --quiet --detach "$work/$label" "$sha"
+    mkdir -p "$work/bin-$label"
+    for suite in "${suites[@]}"; do
+        local source="$work/$label/benchmarks/$suite.cpp"
+        if [ ! -f "$source" ]; then
+            echo "error: $suite.cpp does not exist at $sha" >&2
+            exit 2
+        fi
+        echo "building $suite at $sha"
+        # shellcheck disable=SC2086  # CXXFLAGS is a list of flags
+        "$CXX" $CXXFLAGS -DBENCH_COMMIT="\"$sha\"" -DBENCH_FLAGS="\"$CXXFLAGS\"" \
+            "$source" -o "$work/bin-$label/$suite"
+    done
+}
+
+build baseline "$baseline_sha"
+build candidate "$candidate_sha"
+"$CXX" -std=c++20 -O2 "$root/benchmarks/bench-compare.cpp" -o "$work/bench-compare"
+
+for round in $(seq 1 "$ROUNDS"); do
+    for suite in "${suites[@]}"; do
+        echo "round $round/$ROUNDS: $suite"
+        # shellcheck disable=SC2086  # BENCH_ARGS is a list of options
+        "$work/bin-baseline/$suite" $BENCH_ARGS --json="$baseline_json" > /dev/null
+        # shellcheck disable=SC2086
+        "$work/bin-candidate/$suite" $BENCH_ARGS --json="$candidate_json" > /dev/null
+    done
+done
+
+echo
+"$work/bench-compare" "$baseline_json" "$candidate_json"
@@ -1,28 +1,464 @@
-// Track memory allocation easily
+// Track memory allocation easily — thread-safe, sharded 64-bit counters
+//
+// The global operator new/delete can be called from any thread at any time, so the
+// counters behind them must be race-free. A single std::atomic is race-free but every
+// thread fights over the same cache line. Instead each thread writes to its own
+// cache-line sized shard and the shards are summed only when somebody reads them.
+//
+// Every replaceable allocation function is covered: scalar and array, nothrow, and the
+// std::align_val_t overloads. Over-aligned allocations (alignas(64) types, SIMD buffers)
+// are also counted separately together with the alignment padding they cost.
+//
+// Besides totals it keeps two log2 histograms: allocation sizes, and object lifetimes
+// (nanoseconds from new to delete). Short-lived, same-size allocations are exactly the
+// ones a pool or slab should absorb. The lifetimes cost a steady_clock read in every
+// new and every delete — more than the counters themselves (see --bench); build with
+// -DTRACK_LIFETIMES=0 to drop them.
+//
+// Compile: g++ -std=c++20 -O2 -fno-allocation-dce -pthread allocation-tracking.cpp -o allocation-tracking
+//          (-fno-allocation-dce stops GCC from optimizing away the demo's new/delete pairs)
+// Run    : ./allocation-tracking          (demo)
+//          ./allocation-tracking --bench  (compare the metrics backends)
 #include <iostream>
 #include <memory>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
 using namespace std;
 
+#ifndef TRACK_LIFETIMES
+#define TRACK_LIFETIMES 1
+#endif
+
+// Anything stricter than this goes through the std::align_val_t overloads
+constexpr size_t DefaultNewAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+// Bucket i counts values in [2^(i-1), 2^i); bucket 0 counts zero
+constexpr unsigned HistogramBuckets = 65;
+
+inline unsigned Log2Bucket(uint64_t value) { return unsigned(bit_width(value)); }
+
+// Shards are cache-line aligned so two threads never invalidate each other's counters.
+// A shard has exactly one writer while it is claimed, so updates are a plain
+// load + store instead of a locked read-modify-write.
+struct alignas(64) AllocationShard
+{
+	atomic<uint64_t> AllocCount{0};
+	atomic<uint64_t> FreeCount{0};
+	atomic<uint64_t> BytesAllocated{0};
+	atomic<uint64_t> BytesFreed{0};
+	atomic<bool> Claimed{false};
+	uint64_t NextPeakCheck = 0; // only touched by the owning thread
+
+	atomic<uint64_t> AlignedAllocCount{0};
+	atomic<uint64_t> AlignedFreeCount{0};
+	atomic<uint64_t> AlignedBytes{0};	// requested by over-aligned allocations
+	atomic<uint64_t> AlignedPadding{0}; // extra bytes spent to honour their alignment
+
+	atomic<uint64_t> SizeHistogram[HistogramBuckets] = {};	   // bytes per allocation
+	atomic<uint64_t> LifetimeHistogram[HistogramBuckets] = {}; // nanoseconds new → delete
+
+	static void Add(atomic<uint64_t> &counter, uint64_t value)
+	{
+		counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+	}
+};
+
+// Plain snapshot returned to readers, all values are 64-bit so nothing wraps at 4 GiB
+struct AllocationSnapshot
+{
+	uint64_t AllocCount = 0;
+	uint64_t FreeCount = 0;
+	uint64_t BytesAllocated = 0;
+	uint64_t BytesFreed = 0;
+	uint64_t PeakUsage = 0;
+
+	uint64_t AlignedAllocCount = 0;
+	uint64_t AlignedFreeCount = 0;
+	uint64_t AlignedBytes = 0;
+	uint64_t AlignedPadding = 0;
+
+	uint64_t SizeHistogram[HistogramBuckets] = {};
+	uint64_t LifetimeHistogram[HistogramBuckets] = {};
+
+	uint64_t CurrentUsage() const { return BytesAllocated - BytesFreed; }
+	uint64_t LiveAllocations() const { return AllocCount - FreeCount; }
+};
+
 struct AllocationMetrics
 {
-	uint32_t TotalAllocated = 0;
-	uint32_t TotalFreed = 0;
+	static constexpr unsigned ShardCount = 128;
+	// Peak is re-evaluated each time a shard allocates another PeakGranularity bytes
+	static constexpr uint64_t PeakGranularity = 64 * 1024;
+
+	AllocationShard Shards[ShardCount];
+	AllocationShard Overflow; // shared by threads that found every shard claimed
+	atomic<uint64_t> Peak{0};
+
+	void RecordAlloc(size_t size, size_t alignment = DefaultNewAlignment, size_t padding = 0)
+	{
+		AllocationShard *shard = LocalShard();
+		if (!shard)
+		{
+			Overflow.AllocCount.fetch_add(1, memory_order_relaxed);
+			Overflow.BytesAllocated.fetch_add(size, memory_order_relaxed);
+			Overflow.SizeHistogram[Log2Bucket(size)].fetch_add(1, memory_order_relaxed);
+			if (alignment > DefaultNewAlignment)
+			{
+				Overflow.AlignedAllocCount.fetch_add(1, memory_order_relaxed);
+				Overflow.AlignedBytes.fetch_add(size, memory_order_relaxed);
+				Overflow.AlignedPadding.fetch_add(padding, memory_order_relaxed);
+			}
+			return;
+		}
+
+		AllocationShard::Add(shard->AllocCount, 1);
+		AllocationShard::Add(shard->BytesAllocated, size);
+		AllocationShard::Add(shard->SizeHistogram[Log2Bucket(size)], 1);
+		if (alignment > DefaultNewAlignment)
+		{
+			AllocationShard::Add(shard->AlignedAllocCount, 1);
+			AllocationShard::Add(shard->AlignedBytes, size);
+			AllocationShard::Add(shard->AlignedPadding, padding);
+		}
+
+		// Summing every shard on every allocation would defeat the sharding, so the
+		// peak is sampled: accurate to within ShardCount * PeakGranularity bytes.
+		uint64_t total = shard->BytesAllocated.load(memory_order_relaxed);
+		if (total >= shard->NextPeakCheck)
+		{
+			shard->NextPeakCheck = total + PeakGranularity;
+			UpdatePeak(SumUsage());
+		}
+	}
+
+	void RecordFree(size_t size, uint64_t lifetimeNs, size_t alignment = DefaultNewAlignment)
+	{
+		AllocationShard *shard = LocalShard();
+		if (!shard)
+		{
+			Overflow.FreeCount.fetch_add(1, memory_order_relaxed);
+			Overflow.BytesFreed.fetch_add(size, memory_order_relaxed);
+			Overflow.LifetimeHistogram[Log2Bucket(lifetimeNs)].fetch_add(1, memory_order_relaxed);
+			if (alignment > DefaultNewAlignment)
+				Overflow.AlignedFreeCount.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+
+		AllocationShard::Add(shard->FreeCount, 1);
+		AllocationShard::Add(shard->BytesFreed, size);
+		AllocationShard::Add(shard->LifetimeHistogram[Log2Bucket(lifetimeNs)], 1);
+		if (alignment > DefaultNewAlignment)
+			AllocationShard::Add(shard->AlignedFreeCount, 1);
+	}
+
+	AllocationSnapshot Snapshot()
+	{
+		AllocationSnapshot snap;
+		auto accumulate = [&snap](const AllocationShard &shard)
+		{
+			snap.AllocCount += shard.AllocCount.load(memory_order_relaxed);
+			snap.FreeCount += shard.FreeCount.load(memory_order_relaxed);
+			snap.BytesAllocated += shard.BytesAllocated.load(memory_order_relaxed);
+			snap.BytesFreed += shard.BytesFreed.load(memory_order_relaxed);
+			snap.AlignedAllocCount += shard.AlignedAllocCount.load(memory_order_relaxed);
+			snap.AlignedFreeCount += shard.AlignedFreeCount.load(memory_order_relaxed);
+			snap.AlignedBytes += shard.AlignedBytes.load(memory_order_relaxed);
+			snap.AlignedPadding += shard.AlignedPadding.load(memory_order_relaxed);
+			for (unsigned i = 0; i < HistogramBuckets; ++i)
+			{
+				snap.SizeHistogram[i] += shard.SizeHistogram[i].load(memory_order_relaxed);
+				snap.LifetimeHistogram[i] += shard.LifetimeHistogram[i].load(memory_order_relaxed);
+			}
+		};
+		for (const AllocationShard &shard : Shards)
+			accumulate(shard);
+		accumulate(Overflow);
+
+		UpdatePeak(snap.CurrentUsage());
+		snap.PeakUsage = Peak.load(memory_order_relaxed);
+		return snap;
+	}
+
+private:
+	// A thread may record into more than one instance (the global tracker and a
+	// benchmark's own), so it keeps one claim per instance, keyed by an id that is
+	// never reused — a new instance at a freed one's address can't inherit its claims.
+	// A thread that records into more than ClaimsPerThread instances uses Overflow.
+	static constexpr unsigned ClaimsPerThread = 4;
+	static inline atomic<uint64_t> s_NextId{0};
+	atomic<uint64_t> Id{0}; // assigned on first use, so the global stays constant-initialized
+
+	struct ShardClaim
+	{
+		uint64_t MetricsId = 0;			  // 0: unused
+		AllocationShard *Shard = nullptr; // nullptr: every shard was taken, use Overflow
+	};
+
+	// Releases the claimed shards when their thread exits, so an instance must outlive
+	// every thread that recorded into it. The counters stay in place: they are
+	// cumulative, so the next thread to claim a shard simply keeps adding.
+	struct ShardOwner
+	{
+		ShardClaim Claims[ClaimsPerThread];
+
+		~ShardOwner()
+		{
+			for (ShardClaim &claim : Claims)
+				if (claim.Shard)
+					claim.Shard->Claimed.store(false, memory_order_release);
+		}
+	};
+
+	uint64_t InstanceId()
+	{
+		uint64_t id = Id.load(memory_order_acquire);
+		if (id != 0)
+			return id;
+		uint64_t fresh = s_NextId.fetch_add(1, memory_order_relaxed) + 1;
+		return Id.compare_exchange_strong(id, fresh, memory_order_acq_rel) ? fresh : id;
+	}
 
-	uint32_t CurrentUsage() { return TotalAllocated - TotalFreed; }
+	AllocationShard *ClaimShard()
+	{
+		for (AllocationShard &shard : Shards)
+		{
+			bool expected = false;
+			if (!shard.Claimed.load(memory_order_relaxed) &&
+				shard.Claimed.compare_exchange_strong(expected, true, memory_order_acquire))
+				return &shard;
+		}
+		return nullptr;
+	}
+
+	// Only atomics and a thread_local table are touched here (glibc registers the
+	// thread-exit destructor with calloc, not operator new), so this is safe to call
+	// from inside operator new.
+	AllocationShard *LocalShard()
+	{
+		thread_local ShardOwner owner;
+		uint64_t id = InstanceId();
+		for (ShardClaim &claim : owner.Claims)
+		{
+			if (claim.MetricsId == id)
+				return claim.Shard;
+			if (claim.MetricsId == 0)
+			{
+				claim.MetricsId = id;
+				claim.Shard = ClaimShard();
+				return claim.Shard;
+			}
+		}
+		return nullptr;
+	}
+
+	uint64_t SumUsage() const
+	{
+		uint64_t allocated = 0, freed = 0;
+		auto accumulate = [&](const AllocationShard &shard)
+		{
+			// Frees are read first so a racing alloc/free pair can't make usage negative
+			freed += shard.BytesFreed.load(memory_order_relaxed);
+			allocated += shard.BytesAllocated.load(memory_order_relaxed);
+		};
+		for (const AllocationShard &shard : Shards)
+			accumulate(shard);
+		accumulate(Overflow);
+		return allocated > freed ? allocated - freed : 0;
+	}
+
+	void UpdatePeak(uint64_t usage)
+	{
+		uint64_t peak = Peak.load(memory_order_relaxed);
+		while (usage > peak && !Peak.compare_exchange_weak(peak, usage, memory_order_relaxed))
+		{
+		}
+	}
 };
 
+// Constant-initialized: ready before any static constructor can call operator new
 static AllocationMetrics s_AllocationMetrics;
 
-void *operator new(size_t size)
+// Every allocation carries a 16-byte header right in front of it, so delete knows the
+// size and the birth time even when it isn't handed the size.
+//
+//   default alignment:  [header][object...]                 block from malloc
+//   over-aligned (A):   [padding...][header][object...]     block from aligned_alloc(A),
+//                       |<------- A ------->|               object at block + A
+struct AllocationHeader
+{
+	uint64_t Size;
+	uint64_t BirthNs;
+};
+static_assert(sizeof(AllocationHeader) == DefaultNewAlignment, "header must keep malloc's alignment");
+
+static uint64_t NowNs()
+{
+	return uint64_t(chrono::duration_cast<chrono::nanoseconds>(
+						chrono::steady_clock::now().time_since_epoch())
+						.count());
+}
+
+// Birth time for the header; 0 when lifetimes aren't tracked
+static uint64_t HeaderBirthNs() { return TRACK_LIFETIMES ? NowNs() : 0; }
+
+// Offset from the start of the block to the object
+static size_t HeaderOffset(size_t alignment)
+{
+	return alignment > sizeof(AllocationHeader) ? alignment : sizeof(AllocationHeader);
+}
+
+// Every operator new below ends up here; returns nullptr on failure
+static void *TrackedAlloc(size_t size, size_t alignment)
+{
+	size_t offset = HeaderOffset(alignment);
+	if (size > SIZE_MAX - 2 * offset)
+		return nullptr;
+
+	char *block;
+	size_t padding = 0;
+	if (alignment <= DefaultNewAlignment)
+		block = static_cast<char *>(malloc(offset + size));
+	else
+	{
+		// aligned_alloc wants a multiple of the alignment
+		size_t blockSize = (offset + size + alignment - 1) & ~(alignment - 1);
+		padding = blockSize - size - sizeof(AllocationHeader);
+		block = static_cast<char *>(aligned_alloc(alignment, blockSize));
+	}
+	if (!block)
+		return nullptr;
+
+	s_AllocationMetrics.RecordAlloc(size, alignment, padding);
+	char *memory = block + offset;
+	*(reinterpret_cast<AllocationHeader *>(memory) - 1) = {size, HeaderBirthNs()};
+	return memory;
+}
+
+// Every operator delete below ends up here; 'alignment' must match the new that allocated
+static void TrackedFree(void *memory, size_t alignment) noexcept
+{
+	if (!memory)
+		return;
+	AllocationHeader *header = static_cast<AllocationHeader *>(memory) - 1;
+	s_AllocationMetrics.RecordFree(header->Size, TRACK_LIFETIMES ? NowNs() - header->BirthNs : 0, alignment);
+	free(static_cast<char *>(memory) - HeaderOffset(alignment));
+}
+
+static void *TrackedAllocOrThrow(size_t size, size_t alignment)
 {
-	s_AllocationMetrics.TotalAllocated += size;
-	return malloc(size);
+	// Same contract as the standard operator new: retry through the new_handler
+	for (;;)
+	{
+		if (void *memory = TrackedAlloc(size, alignment))
+			return memory;
+
+		new_handler handler = get_new_handler();
+		if (!handler)
+			throw bad_alloc();
+		handler();
+	}
 }
 
-void operator delete(void *memory, size_t size)
+static void *TrackedAllocNoThrow(size_t size, size_t alignment) noexcept
 {
-	s_AllocationMetrics.TotalFreed += size;
-	free(memory);
+	try
+	{
+		return TrackedAllocOrThrow(size, alignment);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+// The full set of replaceable allocation functions. Forgetting any of them sends those
+// allocations to the library's default operator, where the tracker never sees them —
+// and a default delete on a tracked block would free the wrong address.
+void *operator new(size_t size) { return TrackedAllocOrThrow(size, DefaultNewAlignment); }
+void *operator new[](size_t size) { return TrackedAllocOrThrow(size, DefaultNewAlignment); }
+void *operator new(size_t size, align_val_t alignment) { return TrackedAllocOrThrow(size, size_t(alignment)); }
+void *operator new[](size_t size, align_val_t alignment) { return TrackedAllocOrThrow(size, size_t(alignment)); }
+
+void *operator new(size_t size, const nothrow_t &) noexcept { return TrackedAllocNoThrow(size, DefaultNewAlignment); }
+void *operator new[](size_t size, const nothrow_t &) noexcept { return TrackedAllocNoThrow(size, DefaultNewAlignment); }
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept { return TrackedAllocNoThrow(size, size_t(alignment)); }
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept { return TrackedAllocNoThrow(size, size_t(alignment)); }
+
+void operator delete(void *memory) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+void operator delete[](void *memory) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+void operator delete(void *memory, size_t) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+void operator delete[](void *memory, size_t) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+void operator delete(void *memory, const nothrow_t &) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+void operator delete[](void *memory, const nothrow_t &) noexcept { TrackedFree(memory, DefaultNewAlignment); }
+
+void operator delete(void *memory, align_val_t alignment) noexcept { TrackedFree(memory, size_t(alignment)); }
+void operator delete[](void *memory, align_val_t alignment) noexcept { TrackedFree(memory, size_t(alignment)); }
+void operator delete(void *memory, size_t, align_val_t alignment) noexcept { TrackedFree(memory, size_t(alignment)); }
+void operator delete[](void *memory, size_t, align_val_t alignment) noexcept { TrackedFree(memory, size_t(alignment)); }
+void operator delete(void *memory, align_val_t alignment, const nothrow_t &) noexcept { TrackedFree(memory, size_t(alignment)); }
+void operator delete[](void *memory, align_val_t alignment, const nothrow_t &) noexcept { TrackedFree(memory, size_t(alignment)); }
+
+// ---------------------------------------------------------------
+// Histogram dump — printf only, so it is safe to call from anywhere (even at exit)
+// ---------------------------------------------------------------
+static void FormatBound(char *out, size_t outSize, uint64_t value, const char *const units[], uint64_t step)
+{
+	double scaled = double(value);
+	int unit = 0;
+	while (scaled >= double(step) && units[unit + 1])
+	{
+		scaled /= double(step);
+		++unit;
+	}
+	snprintf(out, outSize, "%.4g %s", scaled, units[unit]);
+}
+
+static void PrintHistogram(const char *title, const uint64_t (&buckets)[HistogramBuckets],
+						   const char *const units[], uint64_t step)
+{
+	uint64_t total = 0, largest = 0;
+	for (uint64_t count : buckets)
+	{
+		total += count;
+		largest = max(largest, count);
+	}
+
+	printf("\n%s (%llu samples)\n", title, (unsigned long long)total);
+	if (total == 0)
+		return;
+
+	for (unsigned i = 0; i < HistogramBuckets; ++i)
+	{
+		if (buckets[i] == 0)
+			continue;
+
+		char low[32], high[32];
+		FormatBound(low, sizeof(low), i == 0 ? 0 : uint64_t(1) << (i - 1), units, step);
+		FormatBound(high, sizeof(high), i == 0 ? 1 : (i == 64 ? UINT64_MAX : uint64_t(1) << i), units, step);
+
+		int bar = int(40 * buckets[i] / largest);
+		printf("  [%9s, %9s)  %10llu  %5.1f%%  %.*s\n", low, high, (unsigned long long)buckets[i],
+			   100.0 * double(buckets[i]) / double(total), bar, "########################################");
+	}
+}
+
+static void PrintHistograms()
+{
+	static const char *const sizeUnits[] = {"B", "KiB", "MiB", "GiB", "TiB", nullptr};
+	static const char *const timeUnits[] = {"ns", "us", "ms", "s", nullptr};
+
+	AllocationSnapshot snap = s_AllocationMetrics.Snapshot();
+	PrintHistogram("Allocation sizes", snap.SizeHistogram, sizeUnits, 1024);
+	if (TRACK_LIFETIMES)
+		PrintHistogram("Object lifetimes (new -> delete)", snap.LifetimeHistogram, timeUnits, 1000);
 }
 
 struct Object
@@ -30,20 +466,152 @@ struct Object
 	int x, y, z;
 };
 
+// A cache-line aligned SIMD buffer — new SimdBlock goes through operator new(size_t, align_val_t)
+struct alignas(64) SimdBlock
+{
+	float Lanes[16];
+};
+
 static void PrintMemoryUsage()
 {
-	cout << "Memory usage: " << s_AllocationMetrics.CurrentUsage() << " Bytes\n";
+	AllocationSnapshot snap = s_AllocationMetrics.Snapshot();
+	cout << "Memory usage: " << snap.CurrentUsage() << " Bytes"
+		 << " (allocs: " << snap.AllocCount << ", frees: " << snap.FreeCount
+		 << ", peak: " << snap.PeakUsage << " Bytes)\n";
+}
+
+static void PrintOverAlignedUsage()
+{
+	AllocationSnapshot snap = s_AllocationMetrics.Snapshot();
+	cout << "Over-aligned: " << snap.AlignedAllocCount << " allocs ("
+		 << snap.AlignedAllocCount - snap.AlignedFreeCount << " live), "
+		 << snap.AlignedBytes << " Bytes requested, "
+		 << snap.AlignedPadding << " Bytes of alignment padding\n";
+}
+
+// ---------------------------------------------------------------
+// Benchmark — cost of the bookkeeping alone, without malloc
+// ---------------------------------------------------------------
+
+// The original struct: plain read-modify-write. The relaxed load/store pair compiles
+// to the same instructions as `TotalAllocated += size` but keeps the race defined,
+// so the lost updates it suffers from can be shown instead of being UB.
+struct LegacyMetrics
+{
+	atomic<uint32_t> TotalAllocated{0};
+	atomic<uint32_t> TotalFreed{0};
+
+	void RecordAlloc(size_t size)
+	{
+		TotalAllocated.store(TotalAllocated.load(memory_order_relaxed) + uint32_t(size), memory_order_relaxed);
+	}
+	void RecordFree(size_t size)
+	{
+		TotalFreed.store(TotalFreed.load(memory_order_relaxed) + uint32_t(size), memory_order_relaxed);
+	}
+	uint64_t Allocated() const { return TotalAllocated.load(); }
+};
+
+// One shared atomic: correct, but every thread bounces the same cache line
+struct SingleAtomicMetrics
+{
+	atomic<uint64_t> BytesAllocated{0};
+	atomic<uint64_t> BytesFreed{0};
+
+	void RecordAlloc(size_t size) { BytesAllocated.fetch_add(size, memory_order_relaxed); }
+	void RecordFree(size_t size) { BytesFreed.fetch_add(size, memory_order_relaxed); }
+	uint64_t Allocated() const { return BytesAllocated.load(); }
+};
+
+// Its own instance, not s_AllocationMetrics: each thread claims separate shards in it
+struct ShardedMetrics
+{
+	AllocationMetrics Metrics;
+
+	void RecordAlloc(size_t size) { Metrics.RecordAlloc(size); }
+	void RecordFree(size_t size) { Metrics.RecordFree(size, 0); }
+	uint64_t Allocated() { return Metrics.Snapshot().BytesAllocated; }
+};
+
+// What TrackedAlloc/TrackedFree actually pay per allocation: the sharded counters plus
+// a steady_clock read on each side for the lifetime histogram
+struct ShardedLifetimeMetrics
+{
+	AllocationMetrics Metrics;
+	static inline thread_local uint64_t BirthNs = 0; // stands in for the allocation header
+
+	void RecordAlloc(size_t size)
+	{
+		Metrics.RecordAlloc(size);
+		BirthNs = NowNs();
+	}
+	void RecordFree(size_t size) { Metrics.RecordFree(size, NowNs() - BirthNs); }
+	uint64_t Allocated() { return Metrics.Snapshot().BytesAllocated; }
+};
+
+template <class Backend>
+static void BenchmarkBackend(const char *name, unsigned threadCount, uint64_t opsPerThread)
+{
+	auto backend = make_unique<Backend>();
+	vector<thread> threads;
+
+	auto start = chrono::steady_clock::now();
+	for (unsigned t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&backend, opsPerThread]
+		{
+			for (uint64_t i = 0; i < opsPerThread; ++i)
+			{
+				backend->RecordAlloc(16);
+				backend->RecordFree(16);
+			}
+		});
+	}
+	for (thread &t : threads)
+		t.join();
+	auto end = chrono::steady_clock::now();
+
+	double ns = chrono::duration<double, nano>(end - start).count();
+	uint64_t expected = uint64_t(threadCount) * opsPerThread * 16;
+	uint64_t counted = backend->Allocated();
+
+	cout << "  " << name << ": " << ns / double(opsPerThread) << " ns per alloc+free per thread, counted "
+		 << counted << " / " << expected << " bytes" << (counted == expected ? "" : "  <-- WRONG") << "\n";
+}
+
+static void RunBenchmark()
+{
+	constexpr uint64_t opsPerThread = 10'000'000;
+	unsigned maxThreads = max(4u, thread::hardware_concurrency());
+
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		cout << threads << " thread(s):\n";
+		BenchmarkBackend<LegacyMetrics>("global struct  ", threads, opsPerThread);
+		BenchmarkBackend<SingleAtomicMetrics>("single atomic  ", threads, opsPerThread);
+		BenchmarkBackend<ShardedMetrics>("sharded        ", threads, opsPerThread);
+		BenchmarkBackend<ShardedLifetimeMetrics>("sharded + clock", threads, opsPerThread);
+	}
 }
 
-int main()
+int main(int argc, char **argv)
 {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+	{
+		RunBenchmark();
+		return 0;
+	}
+
+	// Dump both histograms when the program exits
+	atexit(PrintHistograms);
+
 	PrintMemoryUsage();
-	string *str = new string("hello"); // Allocates the 24 bytes
+	string *str = new string("hello"); // Allocates the 32 bytes
 
 	// This won't show up in memory tracking due to SSO (stored inside the object on the stack)
 	// Your operator new is not triggered — no heap allocation happens here.
 	// ( Note: Allocates 0 bytes cause of static allocation )
-	string str2 = "Hello"; 
+	string str2 = "Hello";
 	string strArr[3] = {"Cherry", "Apple", "Banana"};
 
 	PrintMemoryUsage();
@@ -58,5 +626,48 @@ int main()
 	delete str;
 	PrintMemoryUsage();
 
+	// Allocations from other threads are now counted correctly
+	{
+		vector<thread> workers;
+		for (int t = 0; t < 4; ++t)
+		{
+			workers.emplace_back([]
+			{
+				for (int i = 0; i < 1000; ++i)
+					delete new Object();
+
+				// Some longer-lived, bigger buffers so the histograms have a shape
+				vector<unique_ptr<char[]>> buffers;
+				for (int i = 0; i < 100; ++i)
+				{
+					buffers.emplace_back(new char[64 << (i % 10)]);
+					this_thread::sleep_for(chrono::microseconds(10));
+				}
+			});
+		}
+		for (thread &t : workers)
+			t.join();
+	}
+	PrintMemoryUsage();
+
+	// Array, nothrow and over-aligned forms are tracked too
+	{
+		int *numbers = new int[100];					   // operator new[]
+		Object *maybe = new (nothrow) Object();			   // nothrow operator new
+		SimdBlock *block = new SimdBlock();				   // operator new(size_t, align_val_t)
+		SimdBlock *blocks = new SimdBlock[10];			   // operator new[](size_t, align_val_t)
+		SimdBlock *spare = new (nothrow) SimdBlock[3];	   // nothrow + aligned + array
+		PrintMemoryUsage();
+		PrintOverAlignedUsage();
+
+		delete[] spare;
+		delete[] blocks;
+		delete block;
+		delete maybe;
+		delete[] numbers;
+	}
+	PrintMemoryUsage();
+	PrintOverAlignedUsage();
+
 	return 0;
 }
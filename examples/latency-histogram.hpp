@@ -0,0 +1,292 @@
+// Latency histograms — a distribution per region instead of one duration
+//
+// A service that answers in 50 µs on average can still make one request in ten
+// thousand wait 20 ms, and the mean never shows it. LatencyHistogram keeps every
+// sample in a high-dynamic-range (HDR) layout: log-linear buckets, so the bucket
+// width grows with the value and the relative error stays below 1/256 from
+// nanoseconds to hours.
+//
+//   LATENCY_ZONE("handle request");   // records this scope's duration, like Timer
+//   ...
+//   PrintLatencyReport();             // after the recording threads finish
+//
+//   name            count     mean      min      p50      p90      p99    p99.9   p99.99      max
+//   handle request  80000  22.5 µs   2.9 µs   5.8 µs   7.8 µs   8.9 µs   7.9 ms  13.4 ms  20.0 ms
+//
+// Recording is a count-leading-zeros, a shift and an increment into the calling thread's own
+// histogram — O(1), no lock, no atomic read-modify-write. Threads are merged when the
+// report is built; histograms add bucket by bucket, so merging is exact.
+#pragma once
+
+#include "tsc-clock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifndef LATENCY_CLOCK
+#define LATENCY_CLOCK TscClock
+#endif
+
+#define LATENCY_CONCATENATE_DETAIL(x, y) x##y
+#define LATENCY_CONCATENATE(x, y) LATENCY_CONCATENATE_DETAIL(x, y)
+
+// One static region per source location; 'name' must be a string with static storage
+#define LATENCY_ZONE(name)                                                                \
+	static LatencyRegion LATENCY_CONCATENATE(latencyRegion, __LINE__)(name);              \
+	ScopedLatency LATENCY_CONCATENATE(latencyZone, __LINE__)(LATENCY_CONCATENATE(latencyRegion, __LINE__))
+
+// ---------------------------------------------------------------
+// LatencyHistogram — log-linear buckets over [0, 2^MaxBits)
+// ---------------------------------------------------------------
+// Values below 2^SubBucketBits get a bucket each. Above that, every power-of-two range
+// [2^k, 2^(k+1)) is split into 2^(SubBucketBits-1) equal buckets: the top SubBucketBits
+// bits of a value select its bucket, the bits below are the error.
+class LatencyHistogram
+{
+public:
+	static constexpr int SubBucketBits = 8;
+	static constexpr int MaxBits = 44; // 2^44 ns ≈ 4.9 hours; larger values are clamped
+	static constexpr std::uint64_t HalfCount = std::uint64_t(1) << (SubBucketBits - 1);
+	static constexpr std::size_t BucketCount = std::size_t(MaxBits - SubBucketBits + 2) * HalfCount;
+
+	static std::size_t BucketIndex(std::uint64_t value)
+	{
+		if (value < 2 * HalfCount)
+			return std::size_t(value);
+		int shift = 64 - __builtin_clzll(value) - SubBucketBits; // >= 1
+		return std::size_t(shift) * HalfCount + std::size_t(value >> shift);
+	}
+
+	static std::uint64_t BucketLowest(std::size_t index)
+	{
+		if (index < 2 * HalfCount)
+			return index;
+		std::uint64_t shift = index / HalfCount - 1;
+		return (index - shift * HalfCount) << shift;
+	}
+
+	static std::uint64_t BucketWidth(std::size_t index)
+	{
+		return index < 2 * HalfCount ? 1 : std::uint64_t(1) << (index / HalfCount - 1);
+	}
+
+	void Record(std::uint64_t value, std::uint64_t count = 1)
+	{
+		constexpr std::uint64_t Largest = (std::uint64_t(1) << MaxBits) - 1;
+		m_Buckets[BucketIndex(std::min(value, Largest))] += count;
+		m_Count += count;
+		m_Sum += value * count;
+		m_Min = std::min(m_Min, value);
+		m_Max = std::max(m_Max, value);
+	}
+
+	void Merge(const LatencyHistogram &other)
+	{
+		for (std::size_t i = 0; i < BucketCount; ++i)
+			m_Buckets[i] += other.m_Buckets[i];
+		m_Count += other.m_Count;
+		m_Sum += other.m_Sum;
+		m_Min = std::min(m_Min, other.m_Min);
+		m_Max = std::max(m_Max, other.m_Max);
+	}
+
+	void Reset() { *this = LatencyHistogram(); }
+
+	std::uint64_t Count() const { return m_Count; }
+	std::uint64_t Min() const { return m_Count ? m_Min : 0; }
+	std::uint64_t Max() const { return m_Max; }
+	double Mean() const { return m_Count ? double(m_Sum) / double(m_Count) : 0.0; }
+
+	// Smallest recorded value v such that 'percentile' % of the samples are <= v, up to
+	// the bucket's resolution (the middle of the bucket is returned, within [min, max])
+	std::uint64_t ValueAtPercentile(double percentile) const
+	{
+		if (m_Count == 0)
+			return 0;
+		double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+		std::uint64_t rank = std::max<std::uint64_t>(1, std::uint64_t(std::ceil(fraction * double(m_Count))));
+
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			seen += m_Buckets[i];
+			if (seen >= rank)
+			{
+				std::uint64_t middle = BucketLowest(i) + BucketWidth(i) / 2;
+				return std::clamp(middle, Min(), m_Max);
+			}
+		}
+		return m_Max;
+	}
+
+private:
+	std::uint64_t m_Buckets[BucketCount] = {};
+	std::uint64_t m_Count = 0;
+	std::uint64_t m_Sum = 0;
+	std::uint64_t m_Min = UINT64_MAX;
+	std::uint64_t m_Max = 0;
+};
+
+// "812 ns", "48.3 µs", "20.1 ms", "3.20 s" — into a caller's buffer
+inline const char *FormatLatency(double ns, char *buffer, std::size_t size)
+{
+	if (ns < 1e3)
+		std::snprintf(buffer, size, "%.0f ns", ns);
+	else if (ns < 1e6)
+		std::snprintf(buffer, size, "%.1f µs", ns / 1e3);
+	else if (ns < 1e9)
+		std::snprintf(buffer, size, "%.1f ms", ns / 1e6);
+	else
+		std::snprintf(buffer, size, "%.2f s", ns / 1e9);
+	return buffer;
+}
+
+inline constexpr double g_ReportPercentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+inline void PrintLatencyHeader(std::FILE *out)
+{
+	std::fprintf(out, "%-24s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n", "name", "count", "mean", "min", "p50", "p90",
+				 "p99", "p99.9", "p99.99", "max");
+}
+
+inline void PrintLatencyRow(std::FILE *out, const char *name, const LatencyHistogram &histogram)
+{
+	char text[32];
+	std::fprintf(out, "%-24s %9llu", name, (unsigned long long)histogram.Count());
+	// "µs" is two bytes in UTF-8: pad by hand so the columns still line up
+	auto column = [&](double ns)
+	{
+		FormatLatency(ns, text, sizeof(text));
+		int extra = std::strstr(text, "µ") ? 1 : 0;
+		std::fprintf(out, " %*s", 9 + extra, text);
+	};
+	column(histogram.Mean());
+	column(double(histogram.Min()));
+	for (double percentile : g_ReportPercentiles)
+		column(double(histogram.ValueAtPercentile(percentile)));
+	column(double(histogram.Max()));
+	std::fprintf(out, "\n");
+}
+
+// ---------------------------------------------------------------
+// LatencyRegion — one named distribution, one histogram per recording thread
+// ---------------------------------------------------------------
+// Shards are never freed, so a thread's samples survive its exit and are still merged
+// into the report after join().
+class LatencyRegion
+{
+	const char *m_Name;
+	std::uint32_t m_Id;
+	mutable std::mutex m_Mutex; // guards m_Shards; taken once per thread, not per sample
+	std::vector<LatencyHistogram *> m_Shards;
+	LatencyRegion *m_Next = nullptr;
+
+	static std::atomic<LatencyRegion *> &Regions()
+	{
+		static std::atomic<LatencyRegion *> s_Regions{nullptr};
+		return s_Regions;
+	}
+
+	static std::uint32_t NextId()
+	{
+		static std::atomic<std::uint32_t> s_Count{0};
+		return s_Count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	LatencyHistogram *AddShard()
+	{
+		LatencyHistogram *shard = new LatencyHistogram();
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Shards.push_back(shard);
+		return shard;
+	}
+
+public:
+	explicit LatencyRegion(const char *name) : m_Name(name), m_Id(NextId())
+	{
+		std::atomic<LatencyRegion *> &regions = Regions();
+		m_Next = regions.load(std::memory_order_relaxed);
+		while (!regions.compare_exchange_weak(m_Next, this, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	LatencyRegion(const LatencyRegion &) = delete;
+	LatencyRegion &operator=(const LatencyRegion &) = delete;
+
+	const char *Name() const { return m_Name; }
+	const LatencyRegion *Next() const { return m_Next; }
+	static const LatencyRegion *First() { return Regions().load(std::memory_order_acquire); }
+
+	// The calling thread's histogram for this region: a thread_local table indexed by
+	// region id, so the lookup is a bounds check and a load after the first call
+	LatencyHistogram &Local()
+	{
+		thread_local std::vector<LatencyHistogram *> t_Shards;
+		if (m_Id >= t_Shards.size())
+			t_Shards.resize(m_Id + 1, nullptr);
+		if (!t_Shards[m_Id])
+			t_Shards[m_Id] = AddShard();
+		return *t_Shards[m_Id];
+	}
+
+	// Like CollectProfile(): call while the recording threads are idle or joined
+	LatencyHistogram Collect() const
+	{
+		LatencyHistogram merged;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (const LatencyHistogram *shard : m_Shards)
+			merged.Merge(*shard);
+		return merged;
+	}
+};
+
+// ---------------------------------------------------------------
+// BasicScopedLatency<Clock> — RAII, like Timer, but into a histogram
+// ---------------------------------------------------------------
+template <typename Clock>
+class BasicScopedLatency
+{
+	LatencyHistogram *m_Histogram;
+	std::uint64_t m_Begin;
+
+public:
+	explicit BasicScopedLatency(LatencyRegion &region) : m_Histogram(&region.Local())
+	{
+		m_Begin = Clock::Now();
+	}
+
+	~BasicScopedLatency()
+	{
+		m_Histogram->Record(std::uint64_t(Clock::TicksToNs(Clock::Now() - m_Begin)));
+	}
+
+	BasicScopedLatency(const BasicScopedLatency &) = delete;
+	BasicScopedLatency &operator=(const BasicScopedLatency &) = delete;
+};
+
+using ScopedLatency = BasicScopedLatency<LATENCY_CLOCK>;
+
+// Every region that has samples, busiest first
+inline void PrintLatencyReport(std::FILE *out = stdout)
+{
+	std::vector<std::pair<const char *, LatencyHistogram>> rows;
+	for (const LatencyRegion *region = LatencyRegion::First(); region; region = region->Next())
+	{
+		LatencyHistogram histogram = region->Collect();
+		if (histogram.Count())
+			rows.emplace_back(region->Name(), std::move(histogram));
+	}
+	std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b)
+		 { return a.second.Count() > b.second.Count(); });
+
+	PrintLatencyHeader(out);
+	for (const auto &row : rows)
+		PrintLatencyRow(out, row.first, row.second);
+}
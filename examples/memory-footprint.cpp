@@ -1,5 +1,33 @@
 // Find total memory which is occupied by program
+//
+// totalMemoryUsage() adds up sizeof() of its arguments — the stack footprint only.
+// That misses everything a container keeps on the heap and says nothing about what
+// the OS actually holds in RAM, so this file also has:
+//
+//   deepSize(x)        sizeof(x) + the heap capacity x owns (vector, string, list,
+//                      map/set, unordered_map/set), recursively
+//   readMemoryStats()  resident memory straight from /proc/self/statm and
+//                      /proc/self/smaps_rollup (Linux)
+//   MemoryScope        RAII: prints the resident/anonymous delta of a scope
+//
+// Compile: g++ -std=c++17 -O2 memory-footprint.cpp -o memory-footprint
+// Run    : ./memory-footprint         (sizeof of a few variables)
+//          ./memory-footprint --rss   (1M ints in different containers: deep size vs RSS)
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 using namespace std;
 
 // Calculates memory of whole program
@@ -14,19 +42,273 @@ template <class T>
 size_t totalMemoryUsage(const T &last)
 {
     return sizeof(last);
-}   
+}
 
-// When 0 arguments 
+// When 0 arguments
 size_t totalMemoryUsage() { return 0; }
 
-int main()
+// ---------------------------------------------------------------
+// deepSize — sizeof plus the heap memory a value owns
+// ---------------------------------------------------------------
+// Node layouts are libstdc++'s; other standard libraries are within a pointer or two.
+// Every heap block also costs malloc 8-16 bytes of header and rounding on top of this.
+constexpr size_t ListNodeOverhead = 2 * sizeof(void *);                 // prev, next
+constexpr size_t TreeNodeOverhead = 4 * sizeof(void *);                 // color (padded), parent, left, right
+
+// Hash nodes: next, plus the cached hash unless the hash is fast and noexcept —
+// libstdc++ decides with std::__cache_default, so unordered_set<int> nodes have none.
+// Other libraries: counted as cached, an upper bound
+template <class K, class H>
+constexpr size_t hashNodeOverhead()
 {
+#ifdef __GLIBCXX__
+    return sizeof(void *) + (std::__cache_default<K, H>::value ? sizeof(size_t) : 0);
+#else
+    return sizeof(void *) + sizeof(size_t);
+#endif
+}
+
+template <class T>
+size_t deepSize(const T &value);
+
+// Every overload is declared before any is defined: the calls inside them are only
+// looked up where they are written, so map<int, vector<int>> needs vector's overload
+// to be visible already when pair's and map's are defined
+template <class T>
+size_t heapSize(const basic_string<T> &text);
+template <class A, class B>
+size_t heapSize(const pair<A, B> &p);
+template <class T>
+size_t heapSize(const vector<T> &items);
+template <class T>
+size_t heapSize(const list<T> &items);
+template <class K, class C>
+size_t heapSize(const set<K, C> &items);
+template <class K, class V, class C>
+size_t heapSize(const map<K, V, C> &items);
+template <class K, class H, class E>
+size_t heapSize(const unordered_set<K, H, E> &items);
+template <class K, class V, class H, class E>
+size_t heapSize(const unordered_map<K, V, H, E> &items);
+
+// Heap bytes owned by a value, not counting the value itself
+template <class T>
+size_t heapSize(const T &)
+{
+    static_assert(is_trivially_copyable_v<T>, "add a heapSize() overload for this type");
+    return 0;
+}
+
+template <class T>
+size_t heapSize(const basic_string<T> &text)
+{
+    // Short strings live inside the object (SSO); longer ones own capacity() + 1 chars
+    const T *inlineBuffer = reinterpret_cast<const T *>(&text);
+    bool isInline = text.data() >= inlineBuffer &&
+                    text.data() < inlineBuffer + sizeof(text) / sizeof(T);
+    return isInline ? 0 : (text.capacity() + 1) * sizeof(T);
+}
+
+template <class A, class B>
+size_t heapSize(const pair<A, B> &p)
+{
+    return heapSize(p.first) + heapSize(p.second);
+}
+
+template <class T>
+size_t heapSize(const vector<T> &items)
+{
+    size_t total = items.capacity() * sizeof(T);   // reserved but unused slots count too
+    for (const T &item : items)
+        total += heapSize(item);
+    return total;
+}
+
+// Node-based containers: one heap node per element, padded to the node's alignment
+template <class Container>
+size_t nodeHeapSize(const Container &items, size_t nodeOverhead)
+{
+    using Value = typename Container::value_type;
+    constexpr size_t align = alignof(Value) > alignof(void *) ? alignof(Value) : alignof(void *);
+    size_t node = (nodeOverhead + sizeof(Value) + align - 1) & ~(align - 1);
+
+    size_t total = items.size() * node;
+    for (const auto &item : items)
+        total += heapSize(item);
+    return total;
+}
+
+template <class T>
+size_t heapSize(const list<T> &items) { return nodeHeapSize(items, ListNodeOverhead); }
+
+template <class K, class C>
+size_t heapSize(const set<K, C> &items) { return nodeHeapSize(items, TreeNodeOverhead); }
+
+template <class K, class V, class C>
+size_t heapSize(const map<K, V, C> &items) { return nodeHeapSize(items, TreeNodeOverhead); }
+
+// Hash containers add a bucket array of pointers on top of the nodes
+template <class K, class H, class E>
+size_t heapSize(const unordered_set<K, H, E> &items)
+{
+    return nodeHeapSize(items, hashNodeOverhead<K, H>()) + items.bucket_count() * sizeof(void *);
+}
+
+template <class K, class V, class H, class E>
+size_t heapSize(const unordered_map<K, V, H, E> &items)
+{
+    return nodeHeapSize(items, hashNodeOverhead<K, H>()) + items.bucket_count() * sizeof(void *);
+}
+
+template <class T>
+size_t deepSize(const T &value)
+{
+    return sizeof(value) + heapSize(value);
+}
+
+// ---------------------------------------------------------------
+// Resident memory from /proc
+// ---------------------------------------------------------------
+struct MemoryStats
+{
+    size_t resident = 0;   // bytes in RAM: heap, stack, code, mapped files (statm)
+    size_t anonymous = 0;  // bytes in RAM not backed by a file — heap + stacks (smaps_rollup)
+    size_t swapped = 0;    // bytes pushed out to swap (smaps_rollup)
+};
+
+// statm is one line of page counts — cheap enough to read in a loop
+size_t readResidentBytes()
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+
+    unsigned long sizePages = 0, residentPages = 0;
+    if (fscanf(file, "%lu %lu", &sizePages, &residentPages) != 2)
+        residentPages = 0;
+    fclose(file);
+    return size_t(residentPages) * size_t(sysconf(_SC_PAGESIZE));
+}
+
+// smaps_rollup (Linux 4.14+) sums every mapping; slower, but splits out anonymous memory
+MemoryStats readMemoryStats()
+{
+    MemoryStats stats;
+    stats.resident = readResidentBytes();
+
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if (!file)
+        return stats;
+
+    char line[256];
+    size_t kib = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        if (sscanf(line, "Anonymous: %zu kB", &kib) == 1)
+            stats.anonymous = kib * 1024;
+        else if (sscanf(line, "Swap: %zu kB", &kib) == 1)
+            stats.swapped = kib * 1024;
+    }
+    fclose(file);
+    return stats;
+}
+
+// Prints how much resident memory the scope added when it ends
+struct MemoryScope
+{
+    const char *label;
+    MemoryStats before;
+
+    explicit MemoryScope(const char *label) : label(label), before(readMemoryStats()) {}
+
+    ~MemoryScope()
+    {
+        MemoryStats after = readMemoryStats();
+        printf("[%s] RSS %+.1f KiB, anonymous %+.1f KiB\n", label,
+               (double(after.resident) - double(before.resident)) / 1024.0,
+               (double(after.anonymous) - double(before.anonymous)) / 1024.0);
+    }
+
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+};
+
+// ---------------------------------------------------------------
+// --rss: the same 1M ints in different containers
+// ---------------------------------------------------------------
+// Freed heap memory normally stays in the process; hand it back so the next
+// container starts from the same baseline
+void releaseFreedMemory()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+template <class Container, class Fill>
+void measureContainer(const char *label, Fill fill)
+{
+    releaseFreedMemory();
+    MemoryStats before = readMemoryStats();
+
+    Container items;
+    fill(items);
+
+    MemoryStats after = readMemoryStats();
+    printf("  %-28s deepSize %8.1f MiB   RSS delta %8.1f MiB\n", label,
+           double(deepSize(items)) / (1024.0 * 1024.0),
+           (double(after.resident) - double(before.resident)) / (1024.0 * 1024.0));
+}
+
+void runRssMode()
+{
+    constexpr int Count = 1'000'000;
+    printf("%d ints, %zu bytes of payload:\n", Count, Count * sizeof(int));
+
+    measureContainer<vector<int>>("vector<int>", [](vector<int> &v)
+                                  { for (int i = 0; i < Count; ++i) v.push_back(i); });
+    measureContainer<vector<int>>("vector<int> + reserve", [](vector<int> &v)
+                                  { v.reserve(Count); for (int i = 0; i < Count; ++i) v.push_back(i); });
+    measureContainer<list<int>>("list<int>", [](list<int> &l)
+                                { for (int i = 0; i < Count; ++i) l.push_back(i); });
+    measureContainer<set<int>>("set<int>", [](set<int> &s)
+                               { for (int i = 0; i < Count; ++i) s.insert(i); });
+    measureContainer<unordered_set<int>>("unordered_set<int>", [](unordered_set<int> &s)
+                                         { for (int i = 0; i < Count; ++i) s.insert(i); });
+    measureContainer<vector<string>>("vector<string> (24 chars)", [](vector<string> &v)
+                                     { for (int i = 0; i < Count; ++i) v.push_back(string(24, 'x')); });
+    measureContainer<map<int, vector<int>>>("map<int, vector<int>>", [](map<int, vector<int>> &m)
+                                            { for (int i = 0; i < 1000; ++i) m[i].assign(1000, i); });
+
+    // Whatever deepSize misses is malloc's per-block header and size-class rounding
+    // (a 20-byte list node takes a 32-byte chunk)
+
+    // RAII form: attribute whatever a block of code leaves resident
+    releaseFreedMemory();
+    map<int, string> cache;
+    {
+        MemoryScope scope("map<int, string>, 100k entries");
+        for (int i = 0; i < 100'000; ++i)
+            cache.emplace(i, "a value long enough to leave SSO");
+    }
+    printf("  map<int, string> deepSize %.1f MiB\n", double(deepSize(cache)) / (1024.0 * 1024.0));
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--rss") == 0)
+    {
+        runRssMode();
+        return 0;
+    }
+
     int a;
     double b;
     char c;
     float d;
     int arr[10];
 
+    // 13 bytes of members, 24 with padding — struct-layout.cpp prints where it goes
     struct ExampleStruct
     {
         int x;
@@ -40,5 +322,10 @@ int main()
 
     cout << "Total memory occupied: " << totalMemory << " bytes" << std::endl;
 
+    // sizeof sees only the object itself, not what it owns
+    vector<int> numbers(1000);
+    cout << "vector<int>(1000): sizeof " << sizeof(numbers) << " bytes, deepSize "
+         << deepSize(numbers) << " bytes\n";
+
     return 0;
 }
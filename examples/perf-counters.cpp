@@ -0,0 +1,94 @@
+// Hardware counters around the loops from tips/loop-optimizations.md
+//
+// Same element count, very different reasons for the time spent:
+//   vector sum       — streams memory, IPC high, almost no misses
+//   list sum         — pointer chasing, cache and dTLB misses per element
+//   branchy, random  — a data-dependent branch the predictor can't learn
+//   branchy, sorted  — the same branch over sorted data: predictable
+//
+// Compile: g++ -std=c++17 -O2 perf-counters.cpp -o perf-counters
+// Run    : ./perf-counters   (without counter access only wall time is shown)
+#include "perf-counters.hpp"
+
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <random>
+#include <vector>
+using namespace std;
+
+static volatile long long s_Sink;
+
+int main()
+{
+	constexpr size_t Count = 1 << 22;
+
+	{
+		PerfCounterGroup probe;
+		probe.Describe(stdout);
+	}
+
+	vector<int> data(Count);
+	iota(data.begin(), data.end(), 0);
+
+	// A list whose nodes are scattered, as after a long-running program's churn
+	vector<int> shuffled = data;
+	shuffle(shuffled.begin(), shuffled.end(), mt19937(42));
+	list<int> nodes;
+	{
+		vector<list<int>::iterator> positions;
+		positions.reserve(Count);
+		for (int value : shuffled)
+			positions.push_back(nodes.insert(nodes.end(), value));
+		list<int> ordered;
+		for (int value : data)
+			ordered.splice(ordered.end(), nodes, positions[size_t(value)]);
+		nodes.swap(ordered);
+	}
+
+	{
+		PerfTimer timer("vector sum", Count);
+		long long sum = 0;
+		for (int x : data)
+			sum += x;
+		s_Sink = sum;
+	}
+
+	{
+		PerfTimer timer("list sum", Count);
+		long long sum = 0;
+		for (int x : nodes)
+			sum += x;
+		s_Sink = sum;
+	}
+
+	vector<int> random(Count);
+	mt19937 rng(7);
+	for (int &x : random)
+		x = int(rng() % 256);
+
+	auto branchy = [](const vector<int> &values)
+	{
+		long long sum = 0;
+		for (int x : values)
+		{
+			if (x >= 128)
+				sum += x;
+			else
+				sum -= x / 3; // different enough that the compiler keeps a branch
+		}
+		return sum;
+	};
+
+	{
+		PerfTimer timer("branchy, random", Count);
+		s_Sink = branchy(random);
+	}
+
+	sort(random.begin(), random.end());
+	{
+		PerfTimer timer("branchy, sorted", Count);
+		s_Sink = branchy(random);
+	}
+	return 0;
+}
@@ -0,0 +1,269 @@
+// Hardware performance counters — why a loop is slow, not only how slow
+//
+// A perf_event_open group counts, for the calling thread only and in user space only:
+//
+//   cycles, instructions       → IPC (instructions per cycle; ~0.5 is stalled, 3+ is great)
+//   cache misses               → last-level cache misses, i.e. trips to DRAM
+//   branch misses              → mispredicted branches, ~15-20 cycles each
+//   dTLB misses                → data TLB misses, i.e. page walks
+//
+// PerfTimer<Clock> is a drop-in variant of Timer (timer-utility.cpp): it prints wall
+// time from its destructor, plus the counters per iteration when the count is given:
+//
+//   {
+//       PerfTimer timer("sum vector", data.size());
+//       for (int x : data) sum += x;
+//   }
+//
+// Counters are optional. In containers and VMs perf_event_open is often refused
+// (perf_event_paranoid, seccomp) or the virtual CPU has no PMU at all; each event that
+// can't be opened is reported as "n/a", and with none at all only the wall time is printed.
+#pragma once
+
+#include "tsc-clock.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum PerfEventId
+{
+	PerfCycles,
+	PerfInstructions,
+	PerfCacheMisses,
+	PerfBranchMisses,
+	PerfTlbMisses,
+	PerfEventCount
+};
+
+struct PerfEventSpec
+{
+	const char *Name;
+	std::uint32_t Type;
+	std::uint64_t Config;
+};
+
+inline constexpr PerfEventSpec g_PerfEvents[PerfEventCount] = {
+	{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	{"dTLB-misses", PERF_TYPE_HW_CACHE,
+	 PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+// -1 when the file is missing (no perf support in the kernel at all)
+inline int ReadPerfParanoid()
+{
+	int level = -1;
+	if (std::FILE *file = std::fopen("/proc/sys/kernel/perf_event_paranoid", "r"))
+	{
+		if (std::fscanf(file, "%d", &level) != 1)
+			level = -1;
+		std::fclose(file);
+	}
+	return level;
+}
+
+// ---------------------------------------------------------------
+// Counter values from one Start()/Stop() interval
+// ---------------------------------------------------------------
+struct PerfCounts
+{
+	std::uint64_t Values[PerfEventCount] = {};
+	bool Valid[PerfEventCount] = {};
+
+	// < 1 when the kernel had to multiplex the group with other users of the PMU;
+	// Values are already scaled up to the full interval
+	double Coverage = 1.0;
+
+	bool Has(PerfEventId id) const { return Valid[id]; }
+
+	double Ipc() const
+	{
+		if (!Valid[PerfCycles] || !Valid[PerfInstructions] || Values[PerfCycles] == 0)
+			return 0.0;
+		return double(Values[PerfInstructions]) / double(Values[PerfCycles]);
+	}
+};
+
+// ---------------------------------------------------------------
+// PerfCounterGroup — RAII owner of the event file descriptors
+// ---------------------------------------------------------------
+// All events are in one group, so the kernel schedules them onto the PMU together and
+// ratios such as IPC come from the same instructions. Events the CPU doesn't support
+// are left out of the group rather than failing it.
+class PerfCounterGroup
+{
+	int m_Fds[PerfEventCount];
+	int m_Slot[PerfEventCount]; // position of the event in the group read, -1 if absent
+	int m_Leader = -1;
+	int m_Opened = 0;
+	int m_Errno = 0;			// first failure, for Describe()
+
+	static int OpenEvent(const PerfEventSpec &spec, int groupFd)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = spec.Type;
+		attr.config = spec.Config;
+		attr.disabled = groupFd == -1; // the leader starts and stops the whole group
+		attr.exclude_kernel = 1;	   // allowed up to perf_event_paranoid = 2
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return int(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+	}
+
+public:
+	PerfCounterGroup()
+	{
+		for (int id = 0; id < PerfEventCount; ++id)
+		{
+			m_Slot[id] = -1;
+			m_Fds[id] = OpenEvent(g_PerfEvents[id], m_Leader);
+			if (m_Fds[id] < 0)
+			{
+				if (!m_Errno)
+					m_Errno = errno;
+				continue;
+			}
+			if (m_Leader == -1)
+				m_Leader = m_Fds[id];
+			m_Slot[id] = m_Opened++;
+		}
+	}
+
+	~PerfCounterGroup()
+	{
+		for (int fd : m_Fds)
+			if (fd >= 0)
+				close(fd);
+	}
+
+	PerfCounterGroup(const PerfCounterGroup &) = delete;
+	PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+	bool Available() const { return m_Opened > 0; }
+	bool Has(PerfEventId id) const { return m_Slot[id] >= 0; }
+
+	void Start()
+	{
+		if (!Available())
+			return;
+		ioctl(m_Leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(m_Leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+
+	PerfCounts Stop()
+	{
+		PerfCounts counts;
+		if (!Available())
+			return counts;
+		ioctl(m_Leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+		// { nr, time_enabled, time_running, value[nr] }
+		std::uint64_t data[3 + PerfEventCount] = {};
+		if (read(m_Leader, data, sizeof(data)) < ssize_t(3 * sizeof(std::uint64_t)))
+			return counts;
+
+		std::uint64_t enabled = data[1], running = data[2];
+		if (running == 0) // never got onto the PMU
+			return counts;
+		counts.Coverage = double(running) / double(enabled);
+
+		for (int id = 0; id < PerfEventCount; ++id)
+		{
+			if (m_Slot[id] < 0 || std::uint64_t(m_Slot[id]) >= data[0])
+				continue;
+			counts.Values[id] = std::uint64_t(double(data[3 + m_Slot[id]]) / counts.Coverage);
+			counts.Valid[id] = true;
+		}
+		return counts;
+	}
+
+	// One line on why counters are missing, e.g. for a benchmark report header
+	void Describe(std::FILE *out) const
+	{
+		if (m_Opened == PerfEventCount)
+			return;
+		int paranoid = ReadPerfParanoid();
+		const char *reason = "";
+		if (m_Errno == ENOENT || m_Errno == EOPNOTSUPP)
+			reason = " — the CPU (or hypervisor) exposes no such counters";
+		else if (m_Errno == EACCES || m_Errno == EPERM)
+			reason = paranoid > 2 ? " — perf_event_paranoid > 2 forbids it; try: sysctl kernel.perf_event_paranoid=2"
+								  : " — denied (seccomp profile or missing CAP_PERFMON?)";
+		else if (m_Errno == ENOSYS)
+			reason = " — the kernel has no perf_event support";
+		std::fprintf(out, "perf counters: %d of %d available (perf_event_open: %s, paranoid=%d)%s\n", m_Opened,
+					 int(PerfEventCount), std::strerror(m_Errno), paranoid, reason);
+	}
+};
+
+// ---------------------------------------------------------------
+// PerfTimer — Timer plus counters
+// ---------------------------------------------------------------
+inline void PrintPerfCounts(std::FILE *out, const char *name, double ns, const PerfCounts &counts,
+							std::uint64_t iterations)
+{
+	double per = iterations ? double(iterations) : 1.0;
+	std::fprintf(out, "%s: %.3f ms", name ? name : "PerfTimer", ns / 1e6);
+	if (iterations)
+		std::fprintf(out, ", %.2f ns/iter", ns / per);
+	if (counts.Has(PerfCycles) && counts.Has(PerfInstructions))
+		std::fprintf(out, ", IPC %.2f", counts.Ipc());
+	std::fprintf(out, "\n");
+
+	bool any = false;
+	for (bool valid : counts.Valid)
+		any |= valid;
+	if (!any) // PerfCounterGroup::Describe() says why
+		return;
+
+	for (int id = 0; id < PerfEventCount; ++id)
+	{
+		if (counts.Valid[id])
+			std::fprintf(out, "  %-14s %14llu  %10.3f /iter\n", g_PerfEvents[id].Name,
+						 (unsigned long long)counts.Values[id], double(counts.Values[id]) / per);
+		else
+			std::fprintf(out, "  %-14s %14s\n", g_PerfEvents[id].Name, "n/a");
+	}
+	if (counts.Coverage < 1.0)
+		std::fprintf(out, "  (multiplexed: counted %.0f%% of the time, values scaled)\n", counts.Coverage * 100.0);
+}
+
+template <typename Clock = SteadyClock>
+class PerfTimer
+{
+	PerfCounterGroup m_Group; // opened before the clock starts: the syscalls aren't timed
+	const char *m_Name;
+	std::uint64_t m_Iterations;
+	std::uint64_t m_Start;
+
+public:
+	explicit PerfTimer(const char *name = nullptr, std::uint64_t iterations = 0)
+		: m_Name(name), m_Iterations(iterations)
+	{
+		m_Group.Start();
+		m_Start = Clock::Now();
+	}
+
+	~PerfTimer()
+	{
+		std::uint64_t end = Clock::Now();
+		PerfCounts counts = m_Group.Stop();
+		PrintPerfCounts(stdout, m_Name, Clock::TicksToNs(end - m_Start), counts, m_Iterations);
+	}
+
+	PerfTimer(const PerfTimer &) = delete;
+	PerfTimer &operator=(const PerfTimer &) = delete;
+
+	const PerfCounterGroup &Group() const { return m_Group; }
+};
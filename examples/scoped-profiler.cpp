@@ -0,0 +1,133 @@
+// Scoped zone profiler demo — call tree + Chrome trace from a few worker threads
+//
+// Compile: g++ -std=c++17 -O2 -pthread scoped-profiler.cpp -o scoped-profiler
+// Run    : ./scoped-profiler          (writes scoped-profiler-trace.json, open in ui.perfetto.dev)
+//          ./scoped-profiler --bench  (cost of one zone, steady_clock vs TSC)
+#include "scoped-profiler.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// ---------------------------------------------------------------
+// A fake frame: update → (physics, ai) → render, with some real work inside
+// ---------------------------------------------------------------
+static thread_local volatile double s_Sink;
+
+static void Spin(int iterations)
+{
+	double x = 1.0;
+	for (int i = 0; i < iterations; ++i)
+		x = sqrt(x + i);
+	s_Sink = x;
+}
+
+static void Physics()
+{
+	PROFILE_FUNCTION();
+	for (int body = 0; body < 4; ++body)
+	{
+		PROFILE_ZONE("integrate body");
+		Spin(2000);
+	}
+}
+
+static void Ai()
+{
+	PROFILE_FUNCTION();
+	Spin(5000);
+}
+
+static void Render()
+{
+	PROFILE_FUNCTION();
+	{
+		PROFILE_ZONE("cull");
+		Spin(1000);
+	}
+	{
+		PROFILE_ZONE("draw");
+		Spin(8000);
+	}
+}
+
+static void Frame()
+{
+	PROFILE_ZONE("frame");
+	{
+		PROFILE_ZONE("update");
+		Physics();
+		Ai();
+	}
+	Render();
+}
+
+static void RunDemo()
+{
+	vector<thread> workers;
+	for (int t = 0; t < 3; ++t)
+		workers.emplace_back([]
+		{
+			for (int frame = 0; frame < 100; ++frame)
+				Frame();
+		});
+	for (thread &worker : workers)
+		worker.join();
+
+	ProfileCollection profile = CollectProfile();
+	PrintCallTree(profile);
+	printf("\n");
+	PrintZoneLatencies(profile);
+
+	const char *path = "scoped-profiler-trace.json";
+	if (WriteChromeTrace(profile, path))
+		printf("\nWrote %s — open it in https://ui.perfetto.dev\n", path);
+}
+
+// ---------------------------------------------------------------
+// Benchmark — what one zone costs, against the two clock reads it can't avoid
+// ---------------------------------------------------------------
+template <typename Clock>
+static void BenchmarkClock()
+{
+	constexpr int Iterations = 10'000'000;
+
+	auto start = chrono::steady_clock::now();
+	uint64_t sum = 0;
+	for (int i = 0; i < Iterations; ++i)
+	{
+		sum += Clock::Now();
+		sum += Clock::Now();
+	}
+	double clockNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / Iterations;
+
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < Iterations; ++i)
+	{
+		BasicScopedZone<Clock> zone("empty");
+	}
+	double zoneNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / Iterations;
+
+	printf("%s\n", Clock::Name);
+	printf("  two clock reads : %6.1f ns   (checksum %llu)\n", clockNs, (unsigned long long)(sum & 1));
+	printf("  one empty zone  : %6.1f ns   (clock reads + ring buffer write)\n", zoneNs);
+	printf("  recording alone : %6.1f ns\n", zoneNs - clockNs);
+}
+
+static void RunBenchmark()
+{
+	TscClock::PrintCalibration();
+	BenchmarkClock<SteadyClock>();
+	BenchmarkClock<TscClock>();
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		RunBenchmark();
+	else
+		RunDemo();
+	return 0;
+}
@@ -0,0 +1,334 @@
+// Scoped zone profiler — the Timer from timer-utility.cpp, made cheap enough for hot code
+//
+// Timer formats and prints in its destructor, which costs microseconds and serializes
+// threads on cout. A profile zone only takes two timestamps and stores one fixed-size
+// record into its thread's ring buffer: no lock, no allocation, no formatting.
+// Everything else happens later, off the hot path:
+//
+//   PROFILE_ZONE("parse");                       // records [begin, end) of this scope
+//   ...
+//   ProfileCollection profile = CollectProfile(); // after the profiled threads finish
+//   PrintCallTree(profile);                      // aggregated, indented call tree
+//   PrintZoneLatencies(profile);                 // p50 … p99.99 per zone name
+//   WriteChromeTrace(profile, "trace.json");     // open in ui.perfetto.dev
+//
+// A zone is stored once, when it ends, as a complete event (begin + end + depth).
+// That halves the writes compared to separate begin/end records and a wrapped ring
+// can never leave a begin without its end.
+//
+// Timestamps come from TscClock (tsc-clock.hpp) unless PROFILE_CLOCK names another
+// clock before this header is included; BasicScopedZone<Clock> picks one per zone.
+#pragma once
+
+#include "latency-histogram.hpp"
+#include "tsc-clock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifndef PROFILE_CLOCK
+#define PROFILE_CLOCK TscClock
+#endif
+
+#define PROFILE_CONCATENATE_DETAIL(x, y) x##y
+#define PROFILE_CONCATENATE(x, y) PROFILE_CONCATENATE_DETAIL(x, y)
+
+// 'name' must outlive the profile: a string literal, or a string with static storage
+#define PROFILE_ZONE(name) ScopedZone PROFILE_CONCATENATE(profileZone, __COUNTER__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+// ---------------------------------------------------------------
+// Per-thread ring buffer of finished zones
+// ---------------------------------------------------------------
+struct ProfileEvent
+{
+	const char *Name;
+	std::uint64_t BeginNs;
+	std::uint64_t EndNs;
+	std::uint32_t Depth; // 0 = outermost zone of the thread
+};
+
+struct ProfileThreadBuffer
+{
+	// Power of two, so the slot is Head & (Capacity - 1). When full, the oldest zones
+	// are overwritten — a profile always holds the most recent 64Ki zones per thread.
+	static constexpr std::uint32_t Capacity = 1 << 16;
+
+	std::atomic<std::uint64_t> Head{0}; // total zones ever written; only the owning thread stores
+	std::uint32_t ThreadId = 0;
+	std::uint32_t Depth = 0;		  // zones currently open on this thread
+	ProfileThreadBuffer *Next = nullptr;
+	ProfileEvent Events[Capacity];
+};
+
+// Buffers are never freed: they outlive their thread so its zones can still be
+// collected after join(). New buffers are pushed onto a lock-free list.
+inline std::atomic<ProfileThreadBuffer *> g_ProfileBuffers{nullptr};
+inline std::atomic<std::uint32_t> g_ProfileThreadCount{0};
+
+inline ProfileThreadBuffer *LocalProfileBuffer()
+{
+	thread_local ProfileThreadBuffer *buffer = nullptr;
+	if (buffer)
+		return buffer;
+
+	buffer = new ProfileThreadBuffer();
+	buffer->ThreadId = g_ProfileThreadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+	buffer->Next = g_ProfileBuffers.load(std::memory_order_relaxed);
+	while (!g_ProfileBuffers.compare_exchange_weak(buffer->Next, buffer, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+	return buffer;
+}
+
+// ---------------------------------------------------------------
+// BasicScopedZone<Clock> — RAII, like Timer, but it only records
+// ---------------------------------------------------------------
+template <typename Clock>
+class BasicScopedZone
+{
+	ProfileThreadBuffer *m_Buffer;
+	const char *m_Name;
+	std::uint32_t m_Depth;
+	std::uint64_t m_BeginTicks;
+
+public:
+	explicit BasicScopedZone(const char *name)
+		: m_Buffer(LocalProfileBuffer()), m_Name(name), m_Depth(m_Buffer->Depth++)
+	{
+		m_BeginTicks = Clock::Now(); // last, so setup isn't charged to the zone
+	}
+
+	~BasicScopedZone()
+	{
+		std::uint64_t endTicks = Clock::Now();
+
+		// Stored as nanoseconds on steady_clock's timeline, so zones timed with
+		// different clocks still line up in one trace
+		std::uint64_t head = m_Buffer->Head.load(std::memory_order_relaxed);
+		m_Buffer->Events[head & (ProfileThreadBuffer::Capacity - 1)] = {m_Name, Clock::ToNs(m_BeginTicks),
+																		Clock::ToNs(endTicks), m_Depth};
+		m_Buffer->Head.store(head + 1, std::memory_order_release);
+		m_Buffer->Depth--;
+	}
+
+	BasicScopedZone(const BasicScopedZone &) = delete;
+	BasicScopedZone &operator=(const BasicScopedZone &) = delete;
+};
+
+using ScopedZone = BasicScopedZone<PROFILE_CLOCK>;
+
+// ---------------------------------------------------------------
+// Collection — copy the rings out, oldest zone first
+// ---------------------------------------------------------------
+struct ProfileThread
+{
+	std::uint32_t ThreadId;
+	std::uint64_t Dropped; // zones overwritten before collection
+	std::vector<ProfileEvent> Events;
+};
+
+struct ProfileCollection
+{
+	std::uint64_t OriginNs = 0; // earliest timestamp, so traces start at 0
+	std::vector<ProfileThread> Threads;
+};
+
+// Call while the profiled threads are idle (joined, or parked between frames): the
+// rings are read without synchronizing against writers still recording zones.
+inline ProfileCollection CollectProfile()
+{
+	ProfileCollection profile;
+	profile.OriginNs = UINT64_MAX;
+
+	for (ProfileThreadBuffer *buffer = g_ProfileBuffers.load(std::memory_order_acquire); buffer; buffer = buffer->Next)
+	{
+		std::uint64_t head = buffer->Head.load(std::memory_order_acquire);
+		std::uint64_t first = head > ProfileThreadBuffer::Capacity ? head - ProfileThreadBuffer::Capacity : 0;
+
+		ProfileThread thread{buffer->ThreadId, first, {}};
+		thread.Events.reserve(std::size_t(head - first));
+		for (std::uint64_t i = first; i < head; ++i)
+			thread.Events.push_back(buffer->Events[i & (ProfileThreadBuffer::Capacity - 1)]);
+
+		// Zones are written when they end, so children come before their parent:
+		// order by start time (outer zone first on ties) for the tree walk
+		std::sort(thread.Events.begin(), thread.Events.end(), [](const ProfileEvent &a, const ProfileEvent &b)
+			 { return a.BeginNs != b.BeginNs ? a.BeginNs < b.BeginNs : a.Depth < b.Depth; });
+
+		if (!thread.Events.empty())
+			profile.OriginNs = std::min(profile.OriginNs, thread.Events.front().BeginNs);
+		profile.Threads.push_back(std::move(thread));
+	}
+
+	std::sort(profile.Threads.begin(), profile.Threads.end(), [](const ProfileThread &a, const ProfileThread &b)
+		 { return a.ThreadId < b.ThreadId; });
+	if (profile.OriginNs == UINT64_MAX)
+		profile.OriginNs = 0;
+	return profile;
+}
+
+// ---------------------------------------------------------------
+// Call tree — every path of zone names, merged across calls and threads
+// ---------------------------------------------------------------
+struct CallTreeNode
+{
+	const char *Name = nullptr;
+	std::uint64_t Calls = 0;
+	std::uint64_t TotalNs = 0;
+	std::uint64_t ChildNs = 0; // time spent in child zones; self = TotalNs - ChildNs
+	std::vector<CallTreeNode> Children;
+
+	CallTreeNode &Child(const char *name)
+	{
+		// Names are usually literals: compare pointers first, then text
+		for (CallTreeNode &child : Children)
+			if (child.Name == name || std::strcmp(child.Name, name) == 0)
+				return child;
+		Children.push_back(CallTreeNode{name, 0, 0, 0, {}});
+		return Children.back();
+	}
+};
+
+inline CallTreeNode BuildCallTree(const ProfileCollection &profile)
+{
+	CallTreeNode root{"(all threads)", 0, 0, 0, {}};
+
+	for (const ProfileThread &thread : profile.Threads)
+	{
+		// path[d] is the node of the open zone at depth d. Indices, not pointers:
+		// Child() may grow a vector and move its siblings.
+		std::vector<std::vector<std::size_t>> path;
+		for (const ProfileEvent &event : thread.Events)
+		{
+			// A ring that wrapped can start in the middle of a call stack; zones whose
+			// parent was overwritten are attached at the depth that is still known
+			std::size_t depth = std::min<std::size_t>(event.Depth, path.size());
+			path.resize(depth);
+
+			CallTreeNode *node = &root;
+			std::vector<std::size_t> indices = depth ? path[depth - 1] : std::vector<std::size_t>();
+			for (std::size_t index : indices)
+				node = &node->Children[index];
+
+			CallTreeNode *parent = node;
+			node = &parent->Child(event.Name);
+			indices.push_back(std::size_t(node - parent->Children.data()));
+
+			std::uint64_t duration = event.EndNs - event.BeginNs;
+			node->Calls++;
+			node->TotalNs += duration;
+			if (parent != &root)
+				parent->ChildNs += duration;
+			else
+				root.TotalNs += duration;
+
+			path.push_back(std::move(indices));
+		}
+	}
+	return root;
+}
+
+inline void PrintCallTreeNode(const CallTreeNode &node, int indent)
+{
+	std::printf("%*s%-*s %10llu %12.3f %12.3f %10.1f\n", indent, "", 32 - indent, node.Name,
+		   (unsigned long long)node.Calls, double(node.TotalNs) / 1e6, double(node.TotalNs - node.ChildNs) / 1e6,
+		   node.Calls ? double(node.TotalNs) / double(node.Calls) : 0.0);
+
+	std::vector<const CallTreeNode *> children;
+	for (const CallTreeNode &child : node.Children)
+		children.push_back(&child);
+	std::sort(children.begin(), children.end(), [](const CallTreeNode *a, const CallTreeNode *b)
+		 { return a->TotalNs > b->TotalNs; });
+	for (const CallTreeNode *child : children)
+		PrintCallTreeNode(*child, indent + 2);
+}
+
+inline void PrintCallTree(const ProfileCollection &profile)
+{
+	CallTreeNode root = BuildCallTree(profile);
+	std::printf("%-32s %10s %12s %12s %10s\n", "zone", "calls", "total ms", "self ms", "avg ns");
+	for (const CallTreeNode &child : root.Children)
+		PrintCallTreeNode(child, 0);
+
+	for (const ProfileThread &thread : profile.Threads)
+		if (thread.Dropped)
+			std::printf("(thread %u: %llu oldest zones were overwritten)\n", thread.ThreadId,
+				   (unsigned long long)thread.Dropped);
+}
+
+// ---------------------------------------------------------------
+// Latency distribution per zone name — the call tree only has totals and averages
+// ---------------------------------------------------------------
+inline void PrintZoneLatencies(const ProfileCollection &profile, std::FILE *out = stdout)
+{
+	std::vector<std::pair<const char *, LatencyHistogram>> zones;
+	for (const ProfileThread &thread : profile.Threads)
+	{
+		for (const ProfileEvent &event : thread.Events)
+		{
+			auto zone = std::find_if(zones.begin(), zones.end(), [&](const auto &entry)
+				 { return entry.first == event.Name || std::strcmp(entry.first, event.Name) == 0; });
+			if (zone == zones.end())
+			{
+				zones.emplace_back(event.Name, LatencyHistogram());
+				zone = zones.end() - 1;
+			}
+			zone->second.Record(event.EndNs - event.BeginNs);
+		}
+	}
+
+	PrintLatencyHeader(out);
+	for (const auto &zone : zones)
+		PrintLatencyRow(out, zone.first, zone.second);
+}
+
+// ---------------------------------------------------------------
+// Chrome Trace Event JSON — load in ui.perfetto.dev or chrome://tracing
+// ---------------------------------------------------------------
+inline void WriteJsonString(std::FILE *file, const char *text)
+{
+	std::fputc('"', file);
+	for (; *text; ++text)
+	{
+		unsigned char c = static_cast<unsigned char>(*text);
+		if (c == '"' || c == '\\')
+			std::fprintf(file, "\\%c", c);
+		else if (c < 0x20)
+			std::fprintf(file, "\\u%04x", c);
+		else
+			std::fputc(c, file);
+	}
+	std::fputc('"', file);
+}
+
+inline bool WriteChromeTrace(const ProfileCollection &profile, const char *path)
+{
+	std::FILE *file = std::fopen(path, "w");
+	if (!file)
+		return false;
+
+	std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	bool first = true;
+	for (const ProfileThread &thread : profile.Threads)
+	{
+		for (const ProfileEvent &event : thread.Events)
+		{
+			// "X" = complete event; timestamps are microseconds
+			std::fprintf(file, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+					first ? "" : ",\n", thread.ThreadId,
+					double(event.BeginNs - profile.OriginNs) / 1000.0,
+					double(event.EndNs - event.BeginNs) / 1000.0);
+			WriteJsonString(file, event.Name);
+			std::fputc('}', file);
+			first = false;
+		}
+	}
+	std::fprintf(file, "\n]}\n");
+	return std::fclose(file) == 0;
+}
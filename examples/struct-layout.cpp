@@ -0,0 +1,261 @@
+// Struct layout report — member offsets, padding holes and the smallest possible size
+//
+// The compiler keeps members in declaration order and pads each one up to its
+// alignment, so { int; double; char; } costs 24 bytes for 13 bytes of data.
+// Everything below is constexpr: the layout of a struct can be printed at run time
+// and also checked with static_assert, so a padding regression breaks the build.
+//
+//   constexpr auto layout = structLayout<Particle>("Particle",
+//       LAYOUT_MEMBER(Particle, x), LAYOUT_MEMBER(Particle, alive), ...);
+//   static_assert(layout.isComplete(), "a member is missing from the list");
+//   static_assert(layout.paddingBytes() <= 4, "Particle padding budget exceeded");
+//
+// Members are listed explicitly (offsetof needs the name); for aggregates the number
+// of fields is also counted automatically, so a member left out of the list is caught.
+//
+// Compile: g++ -std=c++17 -O2 struct-layout.cpp -o struct-layout
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+// ---------------------------------------------------------------
+// Member description — one per LAYOUT_MEMBER(Type, member)
+// ---------------------------------------------------------------
+struct MemberInfo
+{
+    const char *name;
+    size_t offset;
+    size_t size;
+    size_t align;
+    size_t fields; // initializers it takes in a brace list: array elements count one each
+};
+
+// A C-array member is brace-initialized element by element (brace elision), so
+// int a[4] takes four initializers; any other member takes one
+template <class M>
+constexpr size_t initializerCount()
+{
+    return is_array_v<M> ? sizeof(M) / sizeof(remove_all_extents_t<M>) : 1;
+}
+
+// offsetof is only guaranteed for standard-layout types; GCC and Clang also accept it
+// (with a warning) for others
+#define LAYOUT_MEMBER(Type, member)                                   \
+    MemberInfo                                                        \
+    {                                                                 \
+        #member, offsetof(Type, member), sizeof(Type::member),        \
+            alignof(decltype(Type::member)),                          \
+            initializerCount<decltype(Type::member)>()                \
+    }
+
+// ---------------------------------------------------------------
+// fieldCount<T>() — number of fields of an aggregate, found by brace-initializing it
+// with more and more convert-to-anything arguments until it stops compiling
+// ---------------------------------------------------------------
+struct AnyField
+{
+    template <class T>
+    constexpr operator T() const; // never defined, only used in decltype
+};
+
+template <class T, class Indices, class = void>
+struct IsBraceConstructible : false_type
+{
+};
+
+template <class T, size_t... I>
+struct IsBraceConstructible<T, index_sequence<I...>, void_t<decltype(T{(void(I), AnyField{})...})>>
+    : true_type
+{
+};
+
+// C-array members are counted per element (brace elision), so arrays make this larger
+// than the number of named members; isComplete() compares it with the listed members'
+// initializerCount(). FIELD_COUNT_LIMIT means "that many or more" and is not checked
+constexpr size_t FIELD_COUNT_LIMIT = 64;
+
+template <class T, size_t N = 0>
+constexpr size_t fieldCount()
+{
+    if constexpr (N < FIELD_COUNT_LIMIT && IsBraceConstructible<T, make_index_sequence<N + 1>>::value)
+        return fieldCount<T, N + 1>();
+    else
+        return N;
+}
+
+// ---------------------------------------------------------------
+// StructLayout<N> — the members sorted by offset, plus the numbers derived from them
+// ---------------------------------------------------------------
+template <size_t N>
+struct StructLayout
+{
+    const char *typeName;
+    size_t size;
+    size_t align;
+    size_t aggregateFields; // 0 when T is not an aggregate or has too many fields to count
+    array<MemberInfo, N> members;
+
+    constexpr size_t dataBytes() const
+    {
+        size_t total = 0;
+        for (const MemberInfo &member : members)
+            total += member.size;
+        return total;
+    }
+
+    // Every byte that isn't a listed member: holes between members plus tail padding
+    constexpr size_t paddingBytes() const { return size - dataBytes(); }
+
+    // Hole in front of member i
+    constexpr size_t holeBefore(size_t i) const
+    {
+        size_t previousEnd = i == 0 ? 0 : members[i - 1].offset + members[i - 1].size;
+        return members[i].offset - previousEnd;
+    }
+
+    constexpr size_t tailPadding() const
+    {
+        return N == 0 ? size : size - (members[N - 1].offset + members[N - 1].size);
+    }
+
+    // Members sorted by decreasing alignment leave no holes (sizes are multiples of
+    // their alignment), so the best order only needs tail padding up to 'align'
+    constexpr size_t minimalSize() const
+    {
+        size_t data = dataBytes();
+        return data == 0 ? size : (data + align - 1) / align * align;
+    }
+
+    constexpr size_t listedFields() const
+    {
+        size_t total = 0;
+        for (const MemberInfo &member : members)
+            total += member.fields;
+        return total;
+    }
+
+    constexpr bool isComplete() const { return aggregateFields == 0 || aggregateFields == listedFields(); }
+
+    void print() const
+    {
+        printf("%s: size %zu, align %zu, padding %zu bytes (%.1f%%), minimal size %zu\n",
+               typeName, size, align, paddingBytes(), 100.0 * double(paddingBytes()) / double(size),
+               minimalSize());
+        printf("  offset  size  align  member\n");
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (size_t hole = holeBefore(i))
+                printf("  %6zu  %4zu         (padding)\n", members[i].offset - hole, hole);
+            printf("  %6zu  %4zu  %5zu  %s\n", members[i].offset, members[i].size, members[i].align,
+                   members[i].name);
+        }
+        if (size_t tail = tailPadding())
+            printf("  %6zu  %4zu         (tail padding)\n", size - tail, tail);
+        if (!isComplete())
+            printf("  !! the listed members take %zu initializers, but the aggregate has %zu fields\n",
+                   listedFields(), aggregateFields);
+        printf("\n");
+    }
+};
+
+template <class T, class... Members>
+constexpr StructLayout<sizeof...(Members)> structLayout(const char *typeName, Members... listed)
+{
+    StructLayout<sizeof...(Members)> layout{typeName, sizeof(T), alignof(T), 0, {listed...}};
+    if constexpr (is_aggregate_v<T>)
+    {
+        constexpr size_t fields = fieldCount<T>();
+        layout.aggregateFields = fields < FIELD_COUNT_LIMIT ? fields : 0;
+    }
+
+    // Insertion sort by offset — the list may be in any order
+    for (size_t i = 1; i < layout.members.size(); ++i)
+        for (size_t j = i; j > 0 && layout.members[j].offset < layout.members[j - 1].offset; --j)
+        {
+            MemberInfo swapped = layout.members[j];
+            layout.members[j] = layout.members[j - 1];
+            layout.members[j - 1] = swapped;
+        }
+    return layout;
+}
+
+// ---------------------------------------------------------------
+// Usage
+// ---------------------------------------------------------------
+
+// The struct from memory-footprint.cpp
+struct ExampleStruct
+{
+    int x;
+    double y;
+    char z;
+};
+
+// Same members, largest alignment first
+struct ExampleStructPacked
+{
+    double y;
+    int x;
+    char z;
+};
+
+// A "hot" struct grown one field at a time
+struct Particle
+{
+    bool alive;
+    double x;
+    uint16_t flags;
+    double y;
+    int32_t id;
+    char tag;
+    double z;
+};
+
+// C-array member: 'samples' takes four initializers of the five fieldCount() finds
+struct SensorReading
+{
+    float samples[4];
+    uint8_t channel;
+};
+
+constexpr auto s_ExampleLayout = structLayout<ExampleStruct>(
+    "ExampleStruct",
+    LAYOUT_MEMBER(ExampleStruct, x), LAYOUT_MEMBER(ExampleStruct, y), LAYOUT_MEMBER(ExampleStruct, z));
+
+constexpr auto s_PackedLayout = structLayout<ExampleStructPacked>(
+    "ExampleStructPacked",
+    LAYOUT_MEMBER(ExampleStructPacked, y), LAYOUT_MEMBER(ExampleStructPacked, x),
+    LAYOUT_MEMBER(ExampleStructPacked, z));
+
+constexpr auto s_ParticleLayout = structLayout<Particle>(
+    "Particle",
+    LAYOUT_MEMBER(Particle, alive), LAYOUT_MEMBER(Particle, x), LAYOUT_MEMBER(Particle, flags),
+    LAYOUT_MEMBER(Particle, y), LAYOUT_MEMBER(Particle, id), LAYOUT_MEMBER(Particle, tag),
+    LAYOUT_MEMBER(Particle, z));
+
+constexpr auto s_SensorLayout = structLayout<SensorReading>(
+    "SensorReading",
+    LAYOUT_MEMBER(SensorReading, samples), LAYOUT_MEMBER(SensorReading, channel));
+
+// Padding budgets: adding a badly placed field to these structs is now a compile error
+static_assert(s_ExampleLayout.isComplete() && s_PackedLayout.isComplete() && s_ParticleLayout.isComplete() &&
+                  s_SensorLayout.isComplete(),
+              "a member is missing from a LAYOUT_MEMBER list");
+static_assert(s_PackedLayout.paddingBytes() <= 3, "ExampleStructPacked padding budget exceeded");
+static_assert(s_PackedLayout.size == s_PackedLayout.minimalSize(), "ExampleStructPacked is not optimally ordered");
+
+// Uncomment to see the build break — Particle wastes 16 of its 48 bytes:
+// static_assert(s_ParticleLayout.paddingBytes() <= 8, "Particle padding budget exceeded");
+
+int main()
+{
+    s_ExampleLayout.print();
+    s_PackedLayout.print();
+    s_ParticleLayout.print();
+    s_SensorLayout.print();
+    return 0;
+}
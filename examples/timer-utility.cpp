@@ -1,26 +1,36 @@
 // Timer in c++
+// (printing from the destructor is fine for a one-off measurement; for hot loops and
+//  many threads see scoped-profiler.hpp, which records zones and reports later)
+//
+// The clock is a template parameter: Timer<> uses steady_clock, Timer<TscClock> reads
+// the CPU's time-stamp counter (see tsc-clock.hpp) for sub-microsecond regions.
+// PerfTimer (perf-counters.hpp) adds hardware counters: IPC, cache/branch/TLB misses.
+// LATENCY_ZONE (latency-histogram.hpp) keeps a percentile distribution per region.
+//
+// Compile: g++ -std=c++17 -O2 timer-utility.cpp -o timer-utility
 #include <iostream>
 #include <chrono>
+#include <cstdint>
 #include <thread>
+#include "tsc-clock.hpp"
 using namespace std;
 
+template <typename Clock = SteadyClock>
 struct Timer
 {
-	chrono::time_point<chrono::steady_clock> start, end;
-	chrono::duration<float> duration;
+	uint64_t start;
 
 	Timer()
 	{
-		start = chrono::steady_clock::now();
+		start = Clock::Now();
 	}
 
 	~Timer()
 	{
-		end = chrono::steady_clock::now();
-		duration = end - start;
+		double ns = Clock::TicksToNs(Clock::Now() - start);
 
-		float ms = duration.count() * 1000.0f;
-		cout << "Timer took " << ms << " ms\n";
+		float ms = float(ns / 1e6);
+		cout << "Timer took " << ms << " ms (" << Clock::Name << ")\n";
 	}
 };
 
@@ -33,8 +43,31 @@ void function()
 	}
 }
 
+// What one Now() call costs — the floor under anything a Timer can measure
+template <typename Clock>
+void measureClockCost()
+{
+	constexpr int Calls = 1'000'000;
+	auto begin = chrono::steady_clock::now();
+	uint64_t sum = 0;
+	for (int i = 0; i < Calls; ++i)
+		sum += Clock::Now();
+	double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / Calls;
+	cout << Clock::Name << "::Now() costs " << ns << " ns" << (sum ? "\n" : "");
+}
+
 int main()
 {
 	function();
+
+	TscClock::PrintCalibration(); // also calibrates, outside the timed region
+	measureClockCost<SteadyClock>();
+	measureClockCost<TscClock>();
+
+	// A region far too short for steady_clock to resolve well
+	{
+		Timer<TscClock> timer;
+		this_thread::yield();
+	}
 	return 0;
 }
@@ -0,0 +1,189 @@
+// Clock sources for Timer and the scoped profiler
+//
+// steady_clock::now() goes through clock_gettime — 20 ns on a good day, several times
+// that in some VMs — so it swamps anything shorter than a microsecond. The CPU's
+// time-stamp counter is one instruction away:
+//
+//   SteadyClock  std::chrono::steady_clock, ticks are nanoseconds; works everywhere
+//   TscClock     rdtsc, calibrated once against steady_clock; falls back to
+//                SteadyClock when the TSC is not invariant or the CPU isn't x86
+//
+// Both share one interface, so timing code takes the clock as a template parameter:
+//
+//   std::uint64_t Clock::Now();                    // raw ticks, cheap
+//   std::uint64_t Clock::ToNs(std::uint64_t ticks) // → steady_clock nanoseconds
+//   double        Clock::TicksToNs(std::uint64_t)  // a tick difference in ns
+//
+// ToNs() maps onto steady_clock's timeline, so timestamps from either clock can be
+// mixed and compared.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TSC_CLOCK_X86 1
+#else
+#define TSC_CLOCK_X86 0
+#endif
+
+struct SteadyClock
+{
+	static constexpr const char *Name = "steady_clock";
+
+	static std::uint64_t Now()
+	{
+		return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+								 std::chrono::steady_clock::now().time_since_epoch())
+								 .count());
+	}
+
+	static std::uint64_t ToNs(std::uint64_t ticks) { return ticks; }
+	static double TicksToNs(std::uint64_t ticks) { return double(ticks); }
+};
+
+// ---------------------------------------------------------------
+// TscClock
+// ---------------------------------------------------------------
+struct TscCalibration
+{
+	bool UseTsc = false;		  // false → every call is forwarded to SteadyClock
+	bool Invariant = false;		  // CPUID says the TSC runs at a constant rate in all P/C-states
+	double TicksPerNs = 1.0;
+	std::uint64_t BaseTicks = 0;  // TSC and steady_clock read at the same moment
+	std::uint64_t BaseNs = 0;
+	std::uint64_t NsPerTickQ32 = 0; // ns per tick as 32.32 fixed point for ToNs()
+};
+
+#if TSC_CLOCK_X86
+// CPUID.80000007H:EDX[8] — without it the TSC may stop in deep sleep or change speed
+// with frequency scaling, and calibrated tick rates are meaningless
+inline bool HasInvariantTsc()
+{
+	unsigned eax, ebx, ecx, edx;
+	if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)
+		return false;
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	return (edx >> 8) & 1;
+}
+
+// No lfence/rdtscp: the CPU may execute rdtsc a few instructions early or late,
+// which is less error than the ~10 ns a fence adds to every read
+inline std::uint64_t ReadTsc()
+{
+	return __rdtsc();
+}
+#endif
+
+// Spins for ~20 ms comparing the TSC against steady_clock
+inline TscCalibration CalibrateTsc()
+{
+	TscCalibration calibration;
+#if TSC_CLOCK_X86
+	calibration.Invariant = HasInvariantTsc();
+	if (!calibration.Invariant)
+		return calibration;
+
+	// Bracket each steady_clock read by two TSC reads and keep the tightest pair,
+	// so a preemption between them doesn't skew the result
+	auto sample = [](std::uint64_t &ticks, std::uint64_t &ns)
+	{
+		std::uint64_t best = UINT64_MAX;
+		for (int i = 0; i < 16; ++i)
+		{
+			std::uint64_t before = ReadTsc();
+			std::uint64_t now = SteadyClock::Now();
+			std::uint64_t after = ReadTsc();
+			if (after - before < best)
+			{
+				best = after - before;
+				ticks = before + (after - before) / 2;
+				ns = now;
+			}
+		}
+	};
+
+	std::uint64_t startTicks = 0, startNs = 0, endTicks = 0, endNs = 0;
+	sample(startTicks, startNs);
+	while (SteadyClock::Now() - startNs < 20'000'000)
+	{
+	}
+	sample(endTicks, endNs);
+
+	if (endTicks <= startTicks || endNs <= startNs)
+		return calibration;
+
+	calibration.UseTsc = true;
+	calibration.TicksPerNs = double(endTicks - startTicks) / double(endNs - startNs);
+	calibration.BaseTicks = endTicks;
+	calibration.BaseNs = endNs;
+	calibration.NsPerTickQ32 = std::uint64_t(4294967296.0 / calibration.TicksPerNs);
+#endif
+	return calibration;
+}
+
+// (a * b) >> 32, exact modulo 2^64. Without a 128-bit type (i386, MSVC) it's put
+// together from four 32 x 32 → 64 products
+inline std::uint64_t MultiplyShift32(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+	return std::uint64_t((unsigned __int128)a * b >> 32);
+#else
+	std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+	std::uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+	return (aHigh * bHigh << 32) + aHigh * bLow + aLow * bHigh + (aLow * bLow >> 32);
+#endif
+}
+
+struct TscClock
+{
+	static constexpr const char *Name = "tsc";
+
+	// Calibrated on first use (thread-safe static); call it once at startup to keep
+	// the 20 ms spin out of the first measurement
+	static const TscCalibration &Calibration()
+	{
+		static const TscCalibration s_Calibration = CalibrateTsc();
+		return s_Calibration;
+	}
+
+	static std::uint64_t Now()
+	{
+#if TSC_CLOCK_X86
+		if (Calibration().UseTsc)
+			return ReadTsc();
+#endif
+		return SteadyClock::Now();
+	}
+
+	static std::uint64_t ToNs(std::uint64_t ticks)
+	{
+		const TscCalibration &c = Calibration();
+		if (!c.UseTsc)
+			return ticks;
+
+		// Offset from the calibration point in either direction, scaled in fixed point
+		if (ticks >= c.BaseTicks)
+			return c.BaseNs + MultiplyShift32(ticks - c.BaseTicks, c.NsPerTickQ32);
+		return c.BaseNs - MultiplyShift32(c.BaseTicks - ticks, c.NsPerTickQ32);
+	}
+
+	static double TicksToNs(std::uint64_t ticks)
+	{
+		const TscCalibration &c = Calibration();
+		return c.UseTsc ? double(ticks) / c.TicksPerNs : double(ticks);
+	}
+
+	static void PrintCalibration()
+	{
+		const TscCalibration &c = Calibration();
+		if (c.UseTsc)
+			std::printf("TscClock: invariant TSC at %.3f GHz\n", c.TicksPerNs);
+		else
+			std::printf("TscClock: %s, falling back to steady_clock\n",
+						TSC_CLOCK_X86 ? "TSC is not invariant" : "no TSC on this CPU");
+	}
+};
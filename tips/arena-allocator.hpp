@@ -0,0 +1,238 @@
+// Growable chunked arena — PoolAllocator without the assert
+//
+// PoolAllocator<PoolSize> (Memory_allocation_debugging.md, Level 8) is a fixed array
+// inside the object: it asserts when it runs out, and a large PoolSize blows the stack.
+// Arena keeps the same bump-pointer fast path but:
+//
+//   - starts in a small inline buffer (no heap call at all for small jobs)
+//   - chains heap or mmap chunks of doubling size once the inline buffer is full
+//   - supports checkpoint()/rewind() markers, so per-request scratch memory is
+//     released in O(1) and its chunks are recycled by the next request
+//
+// Memory layout after growing twice:
+//
+//   [inline buffer] ← [chunk 64 KiB] ← [chunk 128 KiB]   (cursor bumps in the newest)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+// ---------------------------------------------------------------
+// Chunk sources — where the arena gets memory once the inline buffer is full
+// ---------------------------------------------------------------
+struct t_HeapChunks
+{
+    static void* acquire(std::size_t size) { return std::malloc(size); }
+    static void  release(void* ptr, std::size_t /*size*/) { std::free(ptr); }
+};
+
+// Chunks straight from the kernel: page-aligned, untouched pages cost no RSS
+struct t_MmapChunks
+{
+    static void* acquire(std::size_t size)
+    {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    static void release(void* ptr, std::size_t size) { ::munmap(ptr, size); }
+};
+
+// ---------------------------------------------------------------
+// t_ArenaMarker — a saved position; rewind() frees everything allocated after it
+// ---------------------------------------------------------------
+struct t_ArenaChunk
+{
+    t_ArenaChunk* prev;   // older chunk (nullptr → the inline buffer comes before it)
+    std::size_t   size;   // total bytes including this header
+};
+
+struct t_ArenaMarker
+{
+    t_ArenaChunk* chunk;
+    char*         cursor;
+};
+
+// ---------------------------------------------------------------
+// Arena<InlineSize, ChunkSource>
+// ---------------------------------------------------------------
+template<std::size_t InlineSize = 4096, typename ChunkSource = t_HeapChunks>
+class Arena
+{
+    static constexpr std::size_t MIN_CHUNK = 64 * 1024;
+    static constexpr std::size_t MAX_CHUNK = 64 * 1024 * 1024;   // growth stops doubling here
+    static constexpr std::size_t HEADER    = (sizeof(t_ArenaChunk) + alignof(std::max_align_t) - 1)
+                                             & ~(alignof(std::max_align_t) - 1);
+
+    alignas(std::max_align_t) char inline_buffer[InlineSize];
+
+    char*         cursor     = inline_buffer;
+    char*         limit      = inline_buffer + InlineSize;
+    t_ArenaChunk* current    = nullptr;   // newest chunk in use (nullptr → inline buffer)
+    t_ArenaChunk* spare      = nullptr;   // chunks released by rewind(), reused first
+    std::size_t   next_size  = MIN_CHUNK;
+    std::size_t   chunk_bytes = 0;        // total bytes held in chunks (in use + spare)
+
+    static char* chunk_begin(t_ArenaChunk* chunk) { return reinterpret_cast<char*>(chunk) + HEADER; }
+    static char* chunk_end(t_ArenaChunk* chunk)   { return reinterpret_cast<char*>(chunk) + chunk->size; }
+
+    static char* align_up(char* ptr, std::size_t align)
+    {
+        std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+        return reinterpret_cast<char*>((p + align - 1) & ~std::uintptr_t(align - 1));
+    }
+
+    // Slow path: current block is full — take a spare chunk or a new one
+    void* alloc_slow(std::size_t size, std::size_t align)
+    {
+        std::size_t needed = HEADER + size + align;
+
+        // rewind() pushes the newest chunk first, so spares come back in the order
+        // they were originally used — smallest first
+        while (spare && spare->size < needed)
+        {
+            t_ArenaChunk* too_small = spare;
+            spare        = too_small->prev;
+            chunk_bytes -= too_small->size;
+            ChunkSource::release(too_small, too_small->size);
+        }
+
+        t_ArenaChunk* chunk = spare;
+        if (chunk)
+        {
+            spare = chunk->prev;
+        }
+        else
+        {
+            // An oversized request gets a dedicated chunk, rounded up to whole pages
+            std::size_t chunk_size = needed > next_size ? (needed + 4095) & ~std::size_t(4095) : next_size;
+
+            chunk = static_cast<t_ArenaChunk*>(ChunkSource::acquire(chunk_size));
+            if (!chunk)
+                throw std::bad_alloc();
+
+            chunk->size  = chunk_size;
+            chunk_bytes += chunk_size;
+            if (next_size < MAX_CHUNK)
+                next_size *= 2;
+        }
+
+        chunk->prev = current;
+        current     = chunk;
+        cursor      = chunk_begin(chunk);
+        limit       = chunk_end(chunk);
+
+        char* aligned = align_up(cursor, align);
+        cursor        = aligned + size;
+        return aligned;
+    }
+
+    static void release_list(t_ArenaChunk* chunk)
+    {
+        while (chunk)
+        {
+            t_ArenaChunk* prev = chunk->prev;
+            ChunkSource::release(chunk, chunk->size);
+            chunk = prev;
+        }
+    }
+
+public:
+    Arena() = default;
+    ~Arena()
+    {
+        release_list(current);
+        release_list(spare);
+    }
+
+    // The cursor points into inline_buffer — copying or moving would dangle
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Fast path: align, compare, bump — the same two arithmetic ops as PoolAllocator
+    void* alloc(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        char* aligned = align_up(cursor, align);
+        if (aligned <= limit && size <= std::size_t(limit - aligned))
+        {
+            cursor = aligned + size;
+            return aligned;
+        }
+        return alloc_slow(size, align);
+    }
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        return new (alloc(sizeof(T), alignof(T))) T(static_cast<Args&&>(args)...);
+    }
+
+    t_ArenaMarker checkpoint() const { return { current, cursor }; }
+
+    // Free everything allocated after 'marker' — O(chunks released), no destructors run.
+    // Released chunks stay on the spare list so the next request doesn't hit malloc.
+    void rewind(t_ArenaMarker marker)
+    {
+        while (current != marker.chunk)
+        {
+            t_ArenaChunk* chunk = current;
+            current     = chunk->prev;
+            chunk->prev = spare;
+            spare       = chunk;
+        }
+        cursor = marker.cursor;
+        limit  = current ? chunk_end(current) : inline_buffer + InlineSize;
+    }
+
+    // Free everything — same as PoolAllocator::reset(), chunks are kept for reuse
+    void reset() { rewind({ nullptr, inline_buffer }); }
+
+    // Give spare chunks back to the ChunkSource
+    void trim()
+    {
+        for (t_ArenaChunk* chunk = spare; chunk; chunk = chunk->prev)
+            chunk_bytes -= chunk->size;
+        release_list(spare);
+        spare = nullptr;
+    }
+
+    // Bytes currently handed out (including padding; older chunks count as full)
+    std::size_t used() const
+    {
+        if (!current)
+            return std::size_t(cursor - inline_buffer);
+
+        std::size_t total = InlineSize + std::size_t(cursor - chunk_begin(current));
+        for (t_ArenaChunk* chunk = current->prev; chunk; chunk = chunk->prev)
+            total += chunk->size - HEADER;
+        return total;
+    }
+
+    std::size_t reserved() const { return InlineSize + chunk_bytes; }
+
+    void print_usage(const char* label = "Arena") const
+    {
+        std::printf("[%s]  used=%zu bytes  reserved=%zu bytes\n", label, used(), reserved());
+    }
+};
+
+// ---------------------------------------------------------------
+// t_ArenaScope — RAII checkpoint: everything allocated inside the scope is rewound
+// ---------------------------------------------------------------
+template<typename ArenaType>
+struct t_ArenaScope
+{
+    ArenaType&    arena;
+    t_ArenaMarker marker;
+
+    explicit t_ArenaScope(ArenaType& a) : arena(a), marker(a.checkpoint()) {}
+    ~t_ArenaScope() { arena.rewind(marker); }
+
+    t_ArenaScope(const t_ArenaScope&)            = delete;
+    t_ArenaScope& operator=(const t_ArenaScope&) = delete;
+};
@@ -0,0 +1,623 @@
+// Asynchronous whole-file reader — keep many reads in flight instead of one at a time
+//
+// A loop of ifstream reads (file-handling.md) has exactly one request at the disk at
+// any moment: the device idles while the program processes a file, and an NVMe drive
+// that could serve 32+ requests in parallel serves one. AsyncFileReader keeps up to
+// queue_depth chunk reads outstanding and hands each file back as soon as it is
+// complete, in completion order:
+//
+//   AsyncFileReader reader(paths, { .queue_depth = 64 });
+//   reader.for_each([](t_FileData file)          // runs on the calling thread
+//   {
+//       if (!file.error)
+//           consume(file.index, file.text());
+//   });
+//
+// or pull files one at a time — from a loop, a state machine or a coroutine:
+//
+//   t_FileData file;
+//   while (reader.next(file))
+//       ...
+//
+// Two engines behind the same interface:
+//
+//   io_uring     raw io_uring_setup/io_uring_enter system calls (no liburing): one
+//                thread, one syscall submits a batch and waits for the next completion
+//   thread pool  queue_depth threads (at most 64) doing blocking pread(); chosen when
+//                io_uring is missing (kernel < 5.1, seccomp, io_uring_disabled) or asked for
+//
+// Files are opened synchronously when their first read is queued; the data reads are
+// what runs asynchronously. Each file is read whole into one buffer, in chunks of
+// chunk_size, so one huge file still uses the full queue depth.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+enum class t_ReadBackend
+{
+    Auto,         // io_uring if the kernel allows it, else the thread pool
+    IoUring,
+    ThreadPool
+};
+
+struct t_ReaderOptions
+{
+    unsigned      queue_depth = 32;        // reads in flight (io_uring) / threads (pool)
+    std::size_t   chunk_size  = 1 << 20;   // largest single read
+    t_ReadBackend backend     = t_ReadBackend::Auto;
+};
+
+struct t_FileData
+{
+    std::size_t                  index = 0;   // position in the path list
+    std::unique_ptr<std::byte[]> data;
+    std::size_t                  size  = 0;
+    int                          error = 0;   // errno of the failed open/read, 0 on success
+
+    std::span<const std::byte> bytes() const { return { data.get(), size }; }
+    std::string_view           text() const { return { reinterpret_cast<const char*>(data.get()), size }; }
+};
+
+// open + fstat + buffer for one file; error set on failure
+inline t_FileData open_for_reading(std::size_t index, const std::string& path, int& fd)
+{
+    t_FileData file;
+    file.index = index;
+    fd         = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        file.error = errno;
+        return file;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        file.error = errno;
+        ::close(fd);
+        fd = -1;
+        return file;
+    }
+    file.size = std::size_t(info.st_size);
+    file.data.reset(new std::byte[file.size ? file.size : 1]);   // uninitialized: read() fills it
+    return file;
+}
+
+// ---------------------------------------------------------------
+// Engine interface
+// ---------------------------------------------------------------
+// Owned by the engine: AsyncFileReader may be moved while pool threads are reading
+using t_PathList = std::shared_ptr<const std::vector<std::string>>;
+
+class t_ReadEngine
+{
+public:
+    virtual ~t_ReadEngine() = default;
+    virtual bool next(t_FileData& out) = 0;   // false once every file was delivered
+};
+
+// ---------------------------------------------------------------
+// io_uring engine
+// ---------------------------------------------------------------
+// The kernel and the program share two rings: the program writes submission entries
+// (SQEs) and advances the SQ tail, the kernel posts completions (CQEs) and advances the
+// CQ tail. Heads and tails are read and written with acquire/release, as in liburing.
+class t_IoUring
+{
+    int             ring_fd = -1;
+    void*           sq_ring = MAP_FAILED;
+    void*           cq_ring = MAP_FAILED;
+    std::size_t     sq_ring_size = 0, cq_ring_size = 0, sqes_size = 0;
+    io_uring_sqe*   sqes = nullptr;
+    unsigned*       sq_head = nullptr;
+    unsigned*       sq_tail = nullptr;
+    unsigned*       sq_array = nullptr;
+    unsigned        sq_mask = 0, sq_entries = 0;
+    unsigned*       cq_head = nullptr;
+    unsigned*       cq_tail = nullptr;
+    unsigned        cq_mask = 0;
+    io_uring_cqe*   cqes = nullptr;
+    unsigned        local_tail = 0;   // SQEs prepared but not yet published
+    unsigned        unsubmitted = 0;
+
+    static unsigned load_acquire(unsigned* p) { return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire); }
+    static void     store_release(unsigned* p, unsigned v) { std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release); }
+
+public:
+    t_IoUring() = default;
+    t_IoUring(const t_IoUring&)            = delete;
+    t_IoUring& operator=(const t_IoUring&) = delete;
+
+    ~t_IoUring()
+    {
+        if (sqes)
+            ::munmap(sqes, sqes_size);
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+            ::munmap(cq_ring, cq_ring_size);
+        if (sq_ring != MAP_FAILED)
+            ::munmap(sq_ring, sq_ring_size);
+        if (ring_fd >= 0)
+            ::close(ring_fd);
+    }
+
+    // errno on failure: ENOSYS (old kernel), EPERM (disabled or filtered), ENOMEM …
+    int init(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0)
+            return errno;
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single  = params.features & IORING_FEAT_SINGLE_MMAP;   // 5.4+: both rings in one mapping
+        if (single)
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+
+        sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                         IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED)
+            return errno;
+        cq_ring = single ? sq_ring
+                         : ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+            return errno;
+
+        sqes_size  = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_map = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                                IORING_OFF_SQES);
+        if (sqes_map == MAP_FAILED)
+            return errno;
+        sqes = static_cast<io_uring_sqe*>(sqes_map);
+
+        char* sq   = static_cast<char*>(sq_ring);
+        char* cq   = static_cast<char*>(cq_ring);
+        sq_head    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail    = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_array   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_mask    = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        cq_head    = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail    = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask    = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes       = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        local_tail = *sq_tail;
+        return 0;
+    }
+
+    // A zeroed SQE to fill in, or nullptr when the submission ring is full
+    io_uring_sqe* get_sqe()
+    {
+        if (local_tail - load_acquire(sq_head) >= sq_entries)
+            return nullptr;
+        unsigned      slot = local_tail & sq_mask;
+        io_uring_sqe* sqe  = &sqes[slot];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array[slot] = slot;
+        local_tail++;
+        unsubmitted++;
+        return sqe;
+    }
+
+    // Publishes the prepared SQEs and, with wait_for > 0, sleeps until that many
+    // completions are available — one system call for both
+    int submit_and_wait(unsigned wait_for)
+    {
+        store_release(sq_tail, local_tail);
+        for (;;)
+        {
+            long result = ::syscall(__NR_io_uring_enter, ring_fd, unsubmitted, wait_for,
+                                    wait_for ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (result >= 0)
+            {
+                unsubmitted -= unsigned(result);
+                return 0;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                return errno;
+            if (errno != EINTR)
+                wait_for = wait_for ? 1 : 0;   // ring busy: reap some completions first
+        }
+    }
+
+    // The oldest unconsumed completion, or nullptr; call seen() when done with it
+    io_uring_cqe* peek()
+    {
+        unsigned head = *cq_head;
+        if (head == load_acquire(cq_tail))
+            return nullptr;
+        return &cqes[head & cq_mask];
+    }
+
+    void seen() { store_release(cq_head, *cq_head + 1); }
+};
+
+class t_UringEngine : public t_ReadEngine
+{
+    struct t_PendingFile
+    {
+        t_FileData  file;
+        int         fd          = -1;
+        std::size_t queued      = 0;   // bytes handed to reads so far
+        unsigned    outstanding = 0;   // chunk reads in flight
+        bool        in_use      = false;
+    };
+
+    struct t_Op
+    {
+        unsigned    file;   // index into 'pending'
+        std::size_t offset;
+        iovec       vector;   // must stay valid until the read completes
+    };
+
+    t_PathList                      paths;
+    t_ReaderOptions                 options;
+    t_IoUring                       ring;
+    std::vector<t_PendingFile>      pending;
+    std::vector<t_Op>               ops;
+    std::vector<unsigned>           free_ops;
+    std::deque<t_FileData>          ready;
+    std::size_t                     next_path = 0;
+    unsigned                        in_flight = 0;
+    int                             current   = -1;   // file whose chunks are being queued
+    int                             ring_error = 0;   // io_uring_enter failed: nothing new is started
+
+    void finish(unsigned id)
+    {
+        t_PendingFile& p = pending[id];
+        if (p.fd >= 0)
+            ::close(p.fd);
+        ready.push_back(std::move(p.file));
+        p = t_PendingFile();
+    }
+
+    void queue_read(unsigned op_id)
+    {
+        t_Op&         op  = ops[op_id];
+        io_uring_sqe* sqe = ring.get_sqe();   // never null: at most queue_depth reads exist
+        sqe->opcode       = IORING_OP_READV;  // 5.1+; IORING_OP_READ needs 5.6
+        sqe->fd           = pending[op.file].fd;
+        sqe->addr         = reinterpret_cast<std::uint64_t>(&op.vector);
+        sqe->len          = 1;
+        sqe->off          = op.offset;
+        sqe->user_data    = op_id;
+        in_flight++;
+    }
+
+    // Starts files and queues chunks until queue_depth reads are in flight
+    void fill()
+    {
+        while (!free_ops.empty())
+        {
+            if (current < 0)
+            {
+                if (next_path == paths->size())
+                    return;
+                unsigned id = 0;
+                while (pending[id].in_use)
+                    id++;
+                t_PendingFile& p = pending[id];
+                p.in_use         = true;
+                p.file           = open_for_reading(next_path, (*paths)[next_path], p.fd);
+                next_path++;
+                if (p.file.error || p.file.size == 0)
+                {
+                    finish(id);
+                    continue;
+                }
+                current = int(id);
+            }
+
+            t_PendingFile& p      = pending[unsigned(current)];
+            std::size_t    length = std::min(options.chunk_size, p.file.size - p.queued);
+            unsigned       op_id  = free_ops.back();
+            free_ops.pop_back();
+            ops[op_id] = { unsigned(current), p.queued, { p.file.data.get() + p.queued, length } };
+            p.queued += length;
+            p.outstanding++;
+            queue_read(op_id);
+            if (p.queued == p.file.size)
+                current = -1;
+        }
+    }
+
+    void complete(unsigned op_id, int result)
+    {
+        in_flight--;
+        t_Op&          op = ops[op_id];
+        t_PendingFile& p  = pending[op.file];
+
+        if (result > 0 && std::size_t(result) < op.vector.iov_len)
+        {
+            // Short read: ask for the rest with the same op
+            op.offset += std::size_t(result);
+            op.vector.iov_base = static_cast<char*>(op.vector.iov_base) + result;
+            op.vector.iov_len -= std::size_t(result);
+            queue_read(op_id);
+            return;
+        }
+        if (result < 0 && result != -EAGAIN && result != -EINTR)
+            p.file.error = -result;
+        else if (result == 0 && !p.file.error)
+            p.file.error = EIO;   // the file shrank while being read
+        else if (result < 0)
+        {
+            queue_read(op_id);   // transient: try again
+            return;
+        }
+
+        free_ops.push_back(op_id);
+        if (p.file.error && current == int(op.file))
+            current = -1;   // an error stops queueing the rest of this file
+        if (--p.outstanding == 0 && (p.queued == p.file.size || p.file.error))
+            finish(op.file);
+    }
+
+public:
+    t_UringEngine(t_PathList paths, t_ReaderOptions options)
+        : paths(std::move(paths)), options(options)
+    {
+    }
+
+    // Abandoned early: the kernel may still be writing into the buffers, so wait
+    // for the reads in flight before they are freed
+    ~t_UringEngine() override
+    {
+        while (in_flight > 0 && ring.submit_and_wait(1) == 0)
+            while (ring.peek())
+            {
+                ring.seen();
+                in_flight--;
+            }
+        for (t_PendingFile& p : pending)
+        {
+            if (in_flight > 0 && p.outstanding > 0)
+                (void)p.file.data.release();   // the ring can't tell us the reads are done: leak, don't free
+            if (p.fd >= 0)
+                ::close(p.fd);
+        }
+    }
+
+    int init()
+    {
+        if (int error = ring.init(options.queue_depth))
+            return error;
+        pending.resize(options.queue_depth + 1);
+        ops.resize(options.queue_depth);
+        for (unsigned i = options.queue_depth; i-- > 0;)
+            free_ops.push_back(i);
+        return 0;
+    }
+
+    bool next(t_FileData& out) override
+    {
+        while (ready.empty() && !ring_error)
+        {
+            fill();
+            if (!ready.empty())
+                break;
+            if (in_flight == 0)
+                return false;   // nothing queued, nothing left to open
+
+            if (int error = ring.submit_and_wait(1))
+            {
+                // The ring itself failed: report every file still pending. Reads already
+                // submitted may yet complete into their buffers, so those files come back
+                // without data and the buffers stay here for the destructor's drain
+                for (unsigned id = 0; id < pending.size(); id++)
+                {
+                    t_PendingFile& p = pending[id];
+                    if (!p.in_use)
+                        continue;
+                    p.file.error = error;
+                    if (p.outstanding == 0)
+                    {
+                        finish(id);
+                        continue;
+                    }
+                    t_FileData failed;
+                    failed.index = p.file.index;
+                    failed.error = error;
+                    ready.push_back(std::move(failed));
+                }
+                for (; next_path < paths->size(); next_path++)   // and every file not opened yet
+                {
+                    t_FileData failed;
+                    failed.index = next_path;
+                    failed.error = error;
+                    ready.push_back(std::move(failed));
+                }
+                ring_error = error;
+                current    = -1;
+                break;
+            }
+            while (io_uring_cqe* cqe = ring.peek())
+            {
+                unsigned op_id  = unsigned(cqe->user_data);
+                int      result = cqe->res;
+                ring.seen();
+                complete(op_id, result);
+            }
+        }
+        if (ready.empty())
+            return false;
+        out = std::move(ready.front());
+        ready.pop_front();
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------
+// Thread-pool engine — blocking pread on queue_depth threads
+// ---------------------------------------------------------------
+class t_PoolEngine : public t_ReadEngine
+{
+    t_PathList                      paths;
+    t_ReaderOptions                 options;
+    std::atomic<std::size_t>        next_path{ 0 };
+    std::mutex                      mutex;
+    std::condition_variable         has_data;    // consumer waits here
+    std::condition_variable         has_room;    // workers wait here when 'ready' is full
+    std::deque<t_FileData>          ready;
+    std::size_t                     max_ready = 0;
+    std::size_t                     running = 0;
+    bool                            stopping = false;
+    std::vector<std::thread>        workers;
+
+    t_FileData read_file(std::size_t index)
+    {
+        int        fd;
+        t_FileData file = open_for_reading(index, (*paths)[index], fd);
+        if (file.error)
+            return file;
+
+        for (std::size_t done = 0; done < file.size;)
+        {
+            std::size_t length = std::min(options.chunk_size, file.size - done);
+            ssize_t     got    = ::pread(fd, file.data.get() + done, length, off_t(done));
+            if (got > 0)
+                done += std::size_t(got);
+            else if (got == 0 || errno != EINTR)
+            {
+                file.error = got == 0 ? EIO : errno;
+                break;
+            }
+        }
+        ::close(fd);
+        return file;
+    }
+
+    void work()
+    {
+        for (;;)
+        {
+            std::size_t index = next_path.fetch_add(1, std::memory_order_relaxed);
+            if (index >= paths->size())
+                break;
+            t_FileData file = read_file(index);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            // Bounded: files wait in memory only until the consumer catches up
+            has_room.wait(lock, [&] { return stopping || ready.size() < max_ready; });
+            if (stopping)
+                break;
+            ready.push_back(std::move(file));
+            has_data.notify_one();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        has_data.notify_one();
+    }
+
+public:
+    t_PoolEngine(t_PathList paths, t_ReaderOptions options)
+        : paths(std::move(paths)), options(options)
+    {
+        std::size_t threads = std::min<std::size_t>({ options.queue_depth ? options.queue_depth : 1, 64,
+                                                      this->paths->size() ? this->paths->size() : 1 });
+        running   = threads;
+        max_ready = 2 * threads;
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ~t_PoolEngine() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        has_room.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    bool next(t_FileData& out) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        has_data.wait(lock, [&] { return !ready.empty() || running == 0; });
+        if (ready.empty())
+            return false;
+        out = std::move(ready.front());
+        ready.pop_front();
+        has_room.notify_one();
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------
+// AsyncFileReader
+// ---------------------------------------------------------------
+class AsyncFileReader
+{
+    std::unique_ptr<t_ReadEngine> engine;
+    t_ReadBackend                 chosen = t_ReadBackend::ThreadPool;
+    int                           uring_error = 0;   // why io_uring wasn't used
+
+public:
+    explicit AsyncFileReader(std::vector<std::string> file_paths, t_ReaderOptions options = {})
+    {
+        auto paths = std::make_shared<const std::vector<std::string>>(std::move(file_paths));
+        options.queue_depth = std::max(1u, std::min(options.queue_depth, 4096u));
+        options.chunk_size  = std::max<std::size_t>(options.chunk_size, 4096);
+
+        if (options.backend != t_ReadBackend::ThreadPool)
+        {
+            auto uring  = std::make_unique<t_UringEngine>(paths, options);
+            uring_error = uring->init();
+            if (!uring_error)
+            {
+                engine = std::move(uring);
+                chosen = t_ReadBackend::IoUring;
+            }
+        }
+        if (!engine)   // Auto without io_uring, ThreadPool, or IoUring that failed
+            engine = std::make_unique<t_PoolEngine>(paths, options);
+    }
+
+    t_ReadBackend backend() const { return chosen; }
+    const char*   backend_name() const { return chosen == t_ReadBackend::IoUring ? "io_uring" : "thread pool"; }
+    int           io_uring_error() const { return uring_error; }
+
+    // The next completed file, in completion order; false when all were delivered
+    bool next(t_FileData& out) { return engine->next(out); }
+
+    // Calls callback(t_FileData) for every file on this thread; returns the failures
+    template<typename Callback>
+    std::size_t for_each(Callback callback)
+    {
+        std::size_t failures = 0;
+        t_FileData  file;
+        while (next(file))
+        {
+            failures += file.error != 0;
+            callback(std::move(file));
+        }
+        return failures;
+    }
+};
@@ -0,0 +1,374 @@
+// Lock-free category-tagged allocation accounting with interned tags
+//
+// The Level 8 category allocator in Memory_allocation_debugging.md looks a bucket up by
+// scanning g_categories and comparing const char* pointers, then bumps plain ints.
+// This version:
+//   - interns each tag to a small integer id once (first use), never scans again
+//   - counts into a per-thread array indexed by that id — one TLS add, no atomics RMW,
+//     no locks, no shared cache lines
+//   - merges all threads on demand with snapshot_categories() for periodic dashboards
+//
+// Compile: g++ -std=c++17 -O2 -pthread category-allocator.cpp -o category-allocator
+// Run    : ./category-allocator          (multi-threaded demo with live snapshots)
+//          ./category-allocator --bench  (linear scan vs interned id)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------
+// t_SpinLock — a mutex that never allocates (safe next to operator new)
+// ---------------------------------------------------------------
+struct t_SpinLock
+{
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    void lock()   { while (flag.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag.clear(std::memory_order_release); }
+};
+
+static constexpr unsigned MAX_CATEGORIES = 64;
+
+// ---------------------------------------------------------------
+// Interning — tag name → small id. Runs once per tag, never on the hot path.
+// ---------------------------------------------------------------
+static const char*           g_category_names[MAX_CATEGORIES];
+static std::atomic<unsigned> g_category_count { 0 };
+static t_SpinLock            g_intern_lock;
+
+// Compares by content, so "Physics" from two translation units is one category.
+// Id 0 is reserved for "Other" (also used when all MAX_CATEGORIES are taken).
+static unsigned intern_category(const char* name)
+{
+    g_intern_lock.lock();
+    if (g_category_count.load(std::memory_order_relaxed) == 0)
+    {
+        g_category_names[0] = "Other";
+        g_category_count.store(1, std::memory_order_release);
+    }
+
+    unsigned count = g_category_count.load(std::memory_order_relaxed);
+    unsigned id    = 0;
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (std::strcmp(g_category_names[i], name) == 0)
+        {
+            id = i;
+            break;
+        }
+    }
+    if (id == 0 && std::strcmp(name, "Other") != 0 && count < MAX_CATEGORIES)
+    {
+        id                   = count;
+        g_category_names[id] = name;
+        g_category_count.store(count + 1, std::memory_order_release);
+    }
+    g_intern_lock.unlock();
+    return id;
+}
+
+// Compile-time tags: a type carries the name, the id is cached in a function-local
+// static after the first call — every later call is one load and a predicted branch.
+template<typename Tag>
+unsigned category_id()
+{
+    static const unsigned id = intern_category(Tag::name);
+    return id;
+}
+
+#define DECLARE_CATEGORY(Name) struct Name { static constexpr const char* name = #Name; }
+
+// ---------------------------------------------------------------
+// Per-thread counters — each thread is the only writer of its own block
+// ---------------------------------------------------------------
+struct t_CategoryCounts
+{
+    std::uint64_t count       = 0;
+    std::uint64_t bytes       = 0;
+    std::uint64_t freed_bytes = 0;
+};
+
+struct t_ThreadCounts
+{
+    // Readers (snapshot) run concurrently, so the counters are atomics — but the
+    // owner only ever does load + store, which compiles to a plain add.
+    std::atomic<std::uint64_t> count[MAX_CATEGORIES]       = {};
+    std::atomic<std::uint64_t> bytes[MAX_CATEGORIES]       = {};
+    std::atomic<std::uint64_t> freed_bytes[MAX_CATEGORIES] = {};
+    t_ThreadCounts*            next                        = nullptr;
+
+    t_ThreadCounts();
+    ~t_ThreadCounts();
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+// Live threads are linked here; exiting threads fold their totals into g_retired
+static t_SpinLock       g_threads_lock;
+static t_ThreadCounts*  g_threads = nullptr;
+static t_CategoryCounts g_retired[MAX_CATEGORIES];
+
+t_ThreadCounts::t_ThreadCounts()
+{
+    g_threads_lock.lock();
+    next      = g_threads;
+    g_threads = this;
+    g_threads_lock.unlock();
+}
+
+t_ThreadCounts::~t_ThreadCounts()
+{
+    g_threads_lock.lock();
+    for (unsigned i = 0; i < MAX_CATEGORIES; i++)
+    {
+        g_retired[i].count       += count[i].load(std::memory_order_relaxed);
+        g_retired[i].bytes       += bytes[i].load(std::memory_order_relaxed);
+        g_retired[i].freed_bytes += freed_bytes[i].load(std::memory_order_relaxed);
+    }
+    t_ThreadCounts** link = &g_threads;
+    while (*link != this)
+        link = &(*link)->next;
+    *link = next;
+    g_threads_lock.unlock();
+}
+
+static thread_local t_ThreadCounts g_thread_counts;
+
+// ---------------------------------------------------------------
+// Tagged allocation — the id is resolved at compile time (Tag) or by the caller
+// ---------------------------------------------------------------
+static void* alloc_tagged(std::size_t size, unsigned id)
+{
+    t_ThreadCounts::add(g_thread_counts.count[id], 1);
+    t_ThreadCounts::add(g_thread_counts.bytes[id], size);
+
+    void* ptr = std::malloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+static void free_tagged(void* ptr, std::size_t size, unsigned id)
+{
+    t_ThreadCounts::add(g_thread_counts.freed_bytes[id], size);
+    std::free(ptr);
+}
+
+template<typename Tag, typename T, typename... Args>
+T* alloc_new(Args&&... args)
+{
+    void* mem = alloc_tagged(sizeof(T), category_id<Tag>());
+    return new (mem) T{ std::forward<Args>(args)... };   // braces: works for aggregates too
+}
+
+template<typename Tag, typename T>
+void free_delete(T* obj)
+{
+    obj->~T();
+    free_tagged(obj, sizeof(T), category_id<Tag>());
+}
+
+// ---------------------------------------------------------------
+// Snapshot — merge retired totals and every live thread's block
+// ---------------------------------------------------------------
+struct t_CategorySnapshot
+{
+    unsigned         size = 0;
+    const char*      names[MAX_CATEGORIES];
+    t_CategoryCounts counts[MAX_CATEGORIES];
+
+    void print(const char* label) const
+    {
+        std::printf("\n======= %s =======\n", label);
+        std::printf("%-14s  %10s  %12s  %12s\n", "Category", "Count", "Bytes", "Live bytes");
+        std::printf("----------------------------------------------------\n");
+        for (unsigned i = 0; i < size; i++)
+        {
+            if (counts[i].count == 0)
+                continue;
+            std::printf("%-14s  %10llu  %12llu  %12llu\n", names[i],
+                        (unsigned long long)counts[i].count,
+                        (unsigned long long)counts[i].bytes,
+                        (unsigned long long)(counts[i].bytes - counts[i].freed_bytes));
+        }
+    }
+};
+
+static t_CategorySnapshot snapshot_categories()
+{
+    t_CategorySnapshot snap;
+    snap.size = g_category_count.load(std::memory_order_acquire);
+    for (unsigned i = 0; i < snap.size; i++)
+        snap.names[i] = g_category_names[i];
+
+    g_threads_lock.lock();
+    for (unsigned i = 0; i < snap.size; i++)
+        snap.counts[i] = g_retired[i];
+
+    for (t_ThreadCounts* t = g_threads; t; t = t->next)
+    {
+        for (unsigned i = 0; i < snap.size; i++)
+        {
+            snap.counts[i].count       += t->count[i].load(std::memory_order_relaxed);
+            snap.counts[i].bytes       += t->bytes[i].load(std::memory_order_relaxed);
+            snap.counts[i].freed_bytes += t->freed_bytes[i].load(std::memory_order_relaxed);
+        }
+    }
+    g_threads_lock.unlock();
+    return snap;
+}
+
+// ---------------------------------------------------------------
+// Usage
+// ---------------------------------------------------------------
+DECLARE_CATEGORY(Physics);
+DECLARE_CATEGORY(Rendering);
+DECLARE_CATEGORY(AI);
+
+struct t_Vec3    { float x, y, z; };
+struct t_Texture { char data[256]; };
+struct t_AiNode  { int state; float weight; };
+
+static void run_demo()
+{
+    std::atomic<bool>        running { true };
+    std::vector<std::thread> workers;
+
+    workers.emplace_back([&] {
+        while (running.load(std::memory_order_relaxed))
+        {
+            t_Vec3* v = alloc_new<Physics, t_Vec3>(1.0f, 2.0f, 3.0f);
+            free_delete<Physics>(v);
+        }
+    });
+    workers.emplace_back([&] {
+        std::vector<t_Texture*> cache;   // textures stay alive → live bytes grow
+        for (int i = 0; i < 1000 && running.load(std::memory_order_relaxed); i++)
+        {
+            cache.push_back(alloc_new<Rendering, t_Texture>());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (t_Texture* t : cache)
+            free_delete<Rendering>(t);
+    });
+    workers.emplace_back([&] {
+        while (running.load(std::memory_order_relaxed))
+        {
+            t_AiNode* n = alloc_new<AI, t_AiNode>(0, 0.8f);
+            free_delete<AI>(n);
+            std::this_thread::yield();
+        }
+    });
+
+    // The dashboard thread: periodic snapshots while workers keep allocating
+    for (int tick = 1; tick <= 3; tick++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        char label[32];
+        std::snprintf(label, sizeof(label), "Snapshot %d", tick);
+        snapshot_categories().print(label);
+    }
+
+    running = false;
+    for (std::thread& w : workers)
+        w.join();
+    snapshot_categories().print("After all threads exited");
+}
+
+// ---------------------------------------------------------------
+// Benchmark — cost of the accounting alone (no malloc)
+// ---------------------------------------------------------------
+struct t_CategoryBucket
+{
+    const char* name  = nullptr;
+    int         count = 0;
+    std::size_t bytes = 0;
+    bool        used  = false;
+};
+
+static t_CategoryBucket g_categories[MAX_CATEGORIES];
+
+// The Level 8 lookup: linear scan on every allocation
+static t_CategoryBucket& get_or_create_bucket(const char* tag)
+{
+    for (unsigned i = 0; i < MAX_CATEGORIES; i++)
+    {
+        if (g_categories[i].used && g_categories[i].name == tag)
+            return g_categories[i];
+    }
+    for (unsigned i = 0; i < MAX_CATEGORIES; i++)
+    {
+        if (!g_categories[i].used)
+        {
+            g_categories[i] = { tag, 0, 0, true };
+            return g_categories[i];
+        }
+    }
+    static t_CategoryBucket dummy;
+    return dummy;
+}
+
+#define DECLARE_BENCH_CATEGORY(N) DECLARE_CATEGORY(Bench##N)
+DECLARE_BENCH_CATEGORY(0);  DECLARE_BENCH_CATEGORY(1);  DECLARE_BENCH_CATEGORY(2);  DECLARE_BENCH_CATEGORY(3);
+DECLARE_BENCH_CATEGORY(4);  DECLARE_BENCH_CATEGORY(5);  DECLARE_BENCH_CATEGORY(6);  DECLARE_BENCH_CATEGORY(7);
+DECLARE_BENCH_CATEGORY(8);  DECLARE_BENCH_CATEGORY(9);  DECLARE_BENCH_CATEGORY(10); DECLARE_BENCH_CATEGORY(11);
+DECLARE_BENCH_CATEGORY(12); DECLARE_BENCH_CATEGORY(13); DECLARE_BENCH_CATEGORY(14); DECLARE_BENCH_CATEGORY(15);
+
+static void run_benchmark()
+{
+    constexpr int ITERATIONS = 50'000'000;
+    static const char* const names[] = { "Bench0", "Bench1", "Bench2",  "Bench3",  "Bench4",  "Bench5",
+                                         "Bench6", "Bench7", "Bench8",  "Bench9",  "Bench10", "Bench11",
+                                         "Bench12", "Bench13", "Bench14", "Bench15" };
+
+    // Pre-register 16 categories in both schemes; the last one is the worst case for the scan
+    for (const char* name : names)
+        get_or_create_bucket(name);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        t_CategoryBucket& bucket = get_or_create_bucket(names[15]);
+        bucket.count++;
+        bucket.bytes += 16;
+    }
+    double scan_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    // Intern the same 16 categories in the same order, so Bench15 is the 16th here too
+    category_id<Bench0>();  category_id<Bench1>();  category_id<Bench2>();  category_id<Bench3>();
+    category_id<Bench4>();  category_id<Bench5>();  category_id<Bench6>();  category_id<Bench7>();
+    category_id<Bench8>();  category_id<Bench9>();  category_id<Bench10>(); category_id<Bench11>();
+    category_id<Bench12>(); category_id<Bench13>(); category_id<Bench14>(); category_id<Bench15>();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        unsigned id = category_id<Bench15>();
+        t_ThreadCounts::add(g_thread_counts.count[id], 1);
+        t_ThreadCounts::add(g_thread_counts.bytes[id], 16);
+    }
+    double interned_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("linear scan + shared ints : %6.2f ns per tagged allocation (not thread-safe)\n", scan_ns / ITERATIONS);
+    std::printf("interned id + TLS array   : %6.2f ns per tagged allocation (thread-safe)\n", interned_ns / ITERATIONS);
+    std::printf("(checksums: %d, %llu)\n", get_or_create_bucket(names[15]).count,
+                (unsigned long long)snapshot_categories().counts[category_id<Bench15>()].count);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+        run_benchmark();
+    else
+        run_demo();
+    return 0;
+}
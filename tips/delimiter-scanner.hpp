@@ -0,0 +1,380 @@
+// SIMD delimiter scanner — split lines, fields and CSV 64 bytes at a time
+//
+// getline and string_view::find look for one delimiter per call: every token pays a
+// call, a fresh scan start and, with getline, a std::string. Here a 64-byte block is
+// compared against the delimiter once (two AVX2 or four SSE2 compares) into a 64-bit
+// mask, and each token is then one count-trailing-zeros away:
+//
+//   for (std::string_view line : split_lines(text))        // getline semantics
+//       for (std::string_view field : split_fields(line, '\t'))
+//           ...
+//
+//   CsvReader csv(text);                                   // RFC 4180 quoting
+//   std::vector<std::string_view> row;
+//   while (csv.next_row(row))
+//       ...
+//
+// Tokens are string_views into the caller's buffer — nothing is copied, so the buffer
+// (a MappedFile, a FastScanner block, a std::string) must outlive them.
+//
+// CSV quotes are found the same way: a prefix XOR over the quote mask marks every byte
+// between an opening and a closing quote, and delimiters there are dropped — no
+// per-character state machine. A field written as "a ""b""" comes back as a ""b"" —
+// outer quotes removed, doubled quotes kept; csv_unescape() turns it into a "b".
+//
+// Without SSE2 (non-x86) the masks are built byte by byte; the scanning logic is the same.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+// ---------------------------------------------------------------
+// 64-byte block → bit masks
+// ---------------------------------------------------------------
+// Loaded once, compared against several characters (the CSV reader needs three)
+class t_Block64
+{
+#if defined(__AVX2__)
+    __m256i lo, hi;
+
+public:
+    explicit t_Block64(const char* p)
+        : lo(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))),
+          hi(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)))
+    {
+    }
+
+    // Bit i set where byte i == c
+    std::uint64_t equal(char c) const
+    {
+        const __m256i needle = _mm256_set1_epi8(c);
+        std::uint64_t low    = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+        std::uint64_t high   = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+        return low | high << 32;
+    }
+#elif defined(__SSE2__)
+    __m128i part[4];
+
+public:
+    explicit t_Block64(const char* p)
+    {
+        for (int i = 0; i < 4; i++)
+            part[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+    }
+
+    std::uint64_t equal(char c) const
+    {
+        const __m128i needle = _mm_set1_epi8(c);
+        std::uint64_t mask   = 0;
+        for (int i = 0; i < 4; i++)
+            mask |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(part[i], needle)))) << (16 * i);
+        return mask;
+    }
+#else
+    const char* bytes;
+
+public:
+    explicit t_Block64(const char* p) : bytes(p) {}
+
+    std::uint64_t equal(char c) const
+    {
+        std::uint64_t mask = 0;
+        for (int i = 0; i < 64; i++)
+            mask |= std::uint64_t(bytes[i] == c) << i;
+        return mask;
+    }
+#endif
+};
+
+// The block at p, which may be shorter than 64 bytes at the end of the text: the tail is
+// copied into a padded buffer so no load reads past 'end'. Returns the mask of valid bits.
+struct t_BlockReader
+{
+    alignas(64) char padded[64];
+
+    std::uint64_t load(const char* p, const char* end, const char*& block)
+    {
+        std::size_t size = std::size_t(end - p);
+        if (size >= 64)
+        {
+            block = p;
+            return ~std::uint64_t(0);
+        }
+        std::memset(padded, 0, sizeof(padded));
+        std::memcpy(padded, p, size);
+        block = padded;
+        return (std::uint64_t(1) << size) - 1;
+    }
+};
+
+// Bit i = XOR of bits 0..i: set from an opening quote up to (not including) its closing quote
+inline std::uint64_t prefix_xor(std::uint64_t bits)
+{
+#if defined(__PCLMUL__)
+    // Carry-less multiply by all-ones is exactly the prefix XOR
+    __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, std::int64_t(bits)), _mm_set1_epi8(char(0xFF)), 0);
+    return std::uint64_t(_mm_cvtsi128_si64(product));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
+
+// ---------------------------------------------------------------
+// Splitting on one delimiter
+// ---------------------------------------------------------------
+// Two flavours of the same range:
+//
+//   split_fields  like the guide's split(): "a,,b," gives "a", "", "b", "" and an empty
+//                 text gives one empty field
+//   split_lines   like getline: a final line without '\n' still counts, a trailing '\n'
+//                 does not start another line, an empty text has none; '\r' is kept
+class t_SplitRange
+{
+    const char* first;
+    const char* last;
+    char        delimiter;
+    bool        lines;
+
+public:
+    class iterator
+    {
+        const char*      base  = nullptr;   // block that 'bits' describes
+        std::uint64_t    bits  = 0;         // delimiters in that block not consumed yet
+        const char*      start = nullptr;   // start of the next token; nullptr after the last
+        const char*      last  = nullptr;
+        char             delimiter = 0;
+        bool             lines = false;
+        bool             done  = true;
+        std::string_view token;
+
+        void load_block()
+        {
+            t_BlockReader reader;
+            const char*   block;
+            std::uint64_t valid = reader.load(base, last, block);
+            bits                = t_Block64(block).equal(delimiter) & valid;
+        }
+
+        // The next delimiter, or nullptr when there are no more
+        const char* find()
+        {
+            for (;;)
+            {
+                if (bits)
+                {
+                    const char* hit = base + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    return hit;
+                }
+                if (last - base <= 64)
+                    return nullptr;
+                base += 64;
+                load_block();
+            }
+        }
+
+        void advance()
+        {
+            if (!start)
+            {
+                done = true;
+                return;
+            }
+            const char* stop = find();
+            if (stop)
+            {
+                token = std::string_view(start, std::size_t(stop - start));
+                start = stop + 1;
+                if (lines && start == last)
+                    start = nullptr;   // "a\n" is one line, not two
+            }
+            else
+            {
+                token = std::string_view(start, std::size_t(last - start));
+                start = nullptr;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string_view*;
+        using reference         = const std::string_view&;
+
+        iterator() = default;
+
+        iterator(const char* first, const char* last, char delimiter, bool lines)
+            : base(first), start(first), last(last), delimiter(delimiter), lines(lines), done(false)
+        {
+            if (lines && first == last)
+            {
+                done = true;
+                return;
+            }
+            if (first != last)
+                load_block();
+            advance();
+        }
+
+        reference operator*() const { return token; }
+        pointer   operator->() const { return &token; }
+
+        iterator& operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator copy = *this;
+            advance();
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return done == other.done && (done || (token.data() == other.token.data() && token.size() == other.token.size()));
+        }
+    };
+
+    t_SplitRange(std::string_view text, char delimiter, bool lines)
+        : first(text.data()), last(text.data() + text.size()), delimiter(delimiter), lines(lines)
+    {
+    }
+
+    iterator begin() const { return iterator(first, last, delimiter, lines); }
+    iterator end() const { return iterator(); }
+};
+
+inline t_SplitRange split_fields(std::string_view text, char delimiter) { return { text, delimiter, false }; }
+inline t_SplitRange split_lines(std::string_view text) { return { text, '\n', true }; }
+
+// ---------------------------------------------------------------
+// CSV
+// ---------------------------------------------------------------
+// Rows end at '\n' outside quotes ("\r\n" accepted); a quoted field may contain the
+// delimiter, newlines and doubled quotes. An unterminated quote swallows the rest of
+// the text into one field and sets malformed().
+class CsvReader
+{
+    const char*   last;
+    const char*   base;             // block that 'bits' describes
+    const char*   field_start;
+    std::uint64_t bits     = 0;     // delimiters and newlines outside quotes, not consumed yet
+    std::uint64_t inside   = 0;     // all ones when the next block starts inside quotes
+    char          delimiter;
+    bool          finished = false;
+
+    // Delimiters and newlines outside quotes in the block at 'block_start'
+    std::uint64_t structural(const char* block_start)
+    {
+        t_BlockReader reader;
+        const char*   block;
+        std::uint64_t valid = reader.load(block_start, last, block);
+        t_Block64     bytes(block);
+
+        std::uint64_t quoted = prefix_xor(bytes.equal('"') & valid) ^ inside;
+        inside               = std::uint64_t(std::int64_t(quoted) >> 63);   // last bit, broadcast
+        return (bytes.equal(delimiter) | bytes.equal('\n')) & ~quoted & valid;
+    }
+
+    static std::string_view field(const char* start, const char* stop, bool row_end)
+    {
+        if (row_end && stop > start && stop[-1] == '\r')
+            --stop;
+        if (stop - start >= 2 && *start == '"' && stop[-1] == '"')
+        {
+            ++start;
+            --stop;
+        }
+        return std::string_view(start, std::size_t(stop - start));
+    }
+
+public:
+    explicit CsvReader(std::string_view text, char delimiter = ',')
+        : last(text.data() + text.size()), base(text.data()), field_start(text.data()), delimiter(delimiter)
+    {
+        if (!text.empty())
+            bits = structural(base);
+    }
+
+    // The fields of the next row, viewing the text; false at the end
+    bool next_row(std::vector<std::string_view>& fields)
+    {
+        fields.clear();
+        if (finished)
+            return false;
+
+        // Work on locals: the stores into 'fields' could alias the members, and the
+        // compiler would reload them after every push_back
+        const char*   block   = base;
+        std::uint64_t pending = bits;
+        const char*   start   = field_start;
+        for (;;)
+        {
+            while (!pending)
+            {
+                if (last - block <= 64)
+                {
+                    finished = true;
+                    if (start == last && fields.empty())
+                        return false;   // the text ended with a newline
+                    fields.push_back(field(start, last, true));
+                    return true;
+                }
+                block += 64;
+                pending = structural(block);
+            }
+            const char* stop = block + __builtin_ctzll(pending);
+            pending &= pending - 1;
+
+            bool row_end = *stop == '\n';
+            fields.push_back(field(start, stop, row_end));
+            start = stop + 1;
+            if (row_end)
+            {
+                base        = block;
+                bits        = pending;
+                field_start = start;
+                return true;
+            }
+        }
+    }
+
+    // An opening quote was never closed
+    bool malformed() const { return finished && inside; }
+};
+
+// A quoted field's content with "" turned back into "
+inline void csv_unescape(std::string_view field, std::string& out)
+{
+    out.clear();
+    for (std::size_t quote; (quote = field.find("\"\"")) != std::string_view::npos; field.remove_prefix(quote + 2))
+    {
+        out.append(field.data(), quote);
+        out += '"';
+    }
+    out.append(field);
+}
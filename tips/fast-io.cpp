@@ -1,4 +1,7 @@
 // Measure speed of optimized cout and printf
+// (benchmarks/bench-fast-io.cpp measures every variant with repeated samples)
+// When even this is too slow — log dumps of millions of lines — see fast-writer.hpp;
+// for the input side (parsing millions of numbers) see fast-scanner.hpp
 #include <iostream>
 #include <cstdio>
 #include <chrono>
@@ -0,0 +1,289 @@
+// Fast input scanner — parse numbers from large text inputs without iostream overhead
+//
+// cin >> x and scanf("%d") pay per value for locale handling, a virtual streambuf or
+// format-string parsing, and a lock. getline + stoi adds a std::string per line.
+// FastScanner reads the input in large blocks and parses in place:
+//
+//   - read(2) into a 1 MiB buffer, or the whole file mapped with mmap
+//   - separators (space, tab, CR, LF — every byte <= ' ') skipped 16 bytes at a time
+//     with SSE2 (32 with AVX2), one compare + movemask + count-trailing-zeros
+//   - numbers parsed with std::from_chars: no locale, no allocation, no exceptions
+//
+//   FastScanner in;                            // stdin; FastScanner in(fd) for any descriptor
+//   FastScanner file("data.txt", FastScanner::MAP);   // or READ
+//   long long value;
+//   while (in.read(value))
+//       sum += value;
+//
+// 1 GiB of random integers, 1 to 10 digits (benchmarks/bench-fast-input.cpp, GCC 12):
+// scanf 111 ns/value, ifstream >> 68, getline + stoll 87, FastScanner 26-28. What is
+// left is mostly branch mispredictions on the random number lengths and signs.
+//
+// read() returns false at the end of input or when the next token isn't a number of
+// that type; failed() tells the two apart.
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// First byte in [p, end) that is not a separator (> ' '), or end
+inline const char* skip_separators(const char* p, const char* end)
+{
+    // Most numbers are followed by a single separator: don't pay for a vector load
+    if (end - p >= 2 && static_cast<unsigned char>(p[1]) > ' ')
+        return static_cast<unsigned char>(p[0]) > ' ' ? p : p + 1;
+
+#if defined(__AVX2__)
+    const __m256i threshold = _mm256_set1_epi8(' ' + 1);
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i  bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        // max(bytes, 0x21) == bytes  ⇔  byte >= 0x21 (unsigned)
+        unsigned mask  = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(bytes, threshold), bytes)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    const __m128i threshold = _mm_set1_epi8(' ' + 1);
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask  = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes, threshold), bytes)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while (p < end && static_cast<unsigned char>(*p) <= ' ')
+        ++p;
+    return p;
+}
+
+// The first '\n' in [p, end), or end
+inline const char* find_newline(const char* p, const char* end)
+{
+#if defined(__AVX2__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i  bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask  = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask  = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while (p < end && *p != '\n')
+        ++p;
+    return p;
+}
+
+class FastScanner
+{
+public:
+    enum Source
+    {
+        READ,   // read(2) into a reused buffer: constant memory, works on pipes
+        MAP     // mmap the whole file: no copy, but needs a regular file
+    };
+
+private:
+    static constexpr std::size_t MAX_TOKEN = 4096;   // longer tokens can't straddle a refill
+
+    int                     fd        = -1;
+    bool                    owns_fd   = false;
+    bool                    at_eof    = false;
+    bool                    has_error = false;
+    std::unique_ptr<char[]> buffer;
+    std::size_t             capacity  = 0;
+    char*                   mapping   = nullptr;
+    std::size_t             mapped    = 0;
+    const char*             cursor    = nullptr;
+    const char*             end       = nullptr;
+
+    // Keeps [cursor, end) — a token cut by the buffer end — and reads behind it
+    bool refill()
+    {
+        if (at_eof || !buffer)
+            return false;
+
+        std::size_t kept = std::size_t(end - cursor);
+        std::memmove(buffer.get(), cursor, kept);
+        cursor = buffer.get();
+        end    = cursor + kept;
+
+        while (std::size_t(end - cursor) < capacity)
+        {
+            ssize_t got = ::read(fd, const_cast<char*>(end), capacity - std::size_t(end - cursor));
+            if (got > 0)
+            {
+                end += got;
+                return true;
+            }
+            if (got == 0 || errno != EINTR)
+            {
+                has_error = got < 0;
+                at_eof    = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Moves the cursor to the start of the next token and makes sure the whole token is
+    // in the buffer: near the end of a block, the rest is read in first
+    bool next_token()
+    {
+        for (;;)
+        {
+            cursor = skip_separators(cursor, end);
+            if (std::size_t(end - cursor) >= MAX_TOKEN || at_eof || !buffer)
+                return cursor < end;
+            if (!refill() && cursor == end)
+                return false;
+        }
+    }
+
+    static bool is_separator(const char* p, const char* end)
+    {
+        return p == end || static_cast<unsigned char>(*p) <= ' ';
+    }
+
+    void open_file(const char* path, Source source)
+    {
+        fd      = ::open(path, O_RDONLY | O_CLOEXEC);
+        owns_fd = fd >= 0;
+        if (fd < 0)
+        {
+            has_error = at_eof = true;
+            return;
+        }
+
+        struct stat info;
+        if (source == MAP && ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            void* data = ::mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                ::madvise(data, std::size_t(info.st_size), MADV_SEQUENTIAL);   // aggressive readahead
+                mapping = static_cast<char*>(data);
+                mapped  = std::size_t(info.st_size);
+                cursor  = mapping;
+                end     = mapping + mapped;
+                at_eof  = true;   // everything is already "read"
+                return;
+            }
+        }
+        allocate(1 << 20);   // READ, or MAP on something that can't be mapped
+    }
+
+    void allocate(std::size_t size)
+    {
+        capacity = size < 2 * MAX_TOKEN ? 2 * MAX_TOKEN : size;
+        buffer.reset(new char[capacity]);
+        cursor = end = buffer.get();
+    }
+
+public:
+    explicit FastScanner(int fd = STDIN_FILENO, std::size_t capacity = 1 << 20) : fd(fd) { allocate(capacity); }
+
+    FastScanner(const char* path, Source source) { open_file(path, source); }
+
+    // Text already in memory (a mapped file, a received message); not copied
+    explicit FastScanner(std::string_view text) : cursor(text.data()), end(text.data() + text.size())
+    {
+        at_eof = true;
+    }
+
+    ~FastScanner()
+    {
+        if (mapping)
+            ::munmap(mapping, mapped);
+        if (owns_fd)
+            ::close(fd);
+    }
+
+    FastScanner(const FastScanner&)            = delete;
+    FastScanner& operator=(const FastScanner&) = delete;
+
+    // Integers and floating point; a leading '+' is accepted (from_chars alone refuses it)
+    template<typename T>
+    bool read(T& value)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "read() parses numbers");
+
+        if (!next_token())
+            return false;
+        const char* begin = cursor;
+        if (*begin == '+' && end - begin > 1 && begin[1] != '-')
+            ++begin;
+
+        // Parse straight from the buffer — no separate pass to find the token's end
+        std::from_chars_result result = std::from_chars(begin, end, value);
+        if (result.ec != std::errc() || !is_separator(result.ptr, end))
+        {
+            has_error = true;   // leave the cursor on the bad token
+            return false;
+        }
+        cursor = result.ptr;
+        return true;
+    }
+
+    // The next whitespace-separated token; valid until the next call
+    bool read_token(std::string_view& token)
+    {
+        if (!next_token())
+            return false;
+        const char* token_end = cursor;
+        while (!is_separator(token_end, end))
+            ++token_end;
+        token  = std::string_view(cursor, std::size_t(token_end - cursor));
+        cursor = token_end;
+        return true;
+    }
+
+    // Drops the rest of the current line, including its '\n'
+    void skip_line()
+    {
+        for (;;)
+        {
+            cursor = find_newline(cursor, end);
+            if (cursor < end)
+            {
+                ++cursor;
+                return;
+            }
+            cursor = end;
+            if (!refill())
+                return;
+        }
+    }
+
+    bool eof() { return !next_token(); }
+
+    bool failed() const { return has_error; }
+};
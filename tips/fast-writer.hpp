@@ -0,0 +1,221 @@
+// Fast buffered writer — for output volumes where even unsynced cout is the bottleneck
+//
+// fast-io.cpp shows sync_with_stdio(false) making cout competitive with printf. Both
+// still pay for locale-aware formatting, a virtual streambuf and (printf) parsing the
+// format string on every call. FastWriter does only what a log dumper needs:
+//
+//   - one large user-space buffer (1 MiB by default), flushed with a single write(2)
+//   - integers through a 200-byte table of digit pairs: the digit count comes from
+//     bit_width and one table compare, then two digits are stored per division by 100
+//   - floating point through std::to_chars (shortest round-trip, or fixed precision)
+//
+//   FastWriter out;                       // stdout; FastWriter out(fd) for any descriptor
+//   for (int i = 0; i < n; ++i)
+//       out << i << '\n';
+//   out.write_fixed(3.14159, 2);          // "3.14"
+//   out.flush();                          // also done by the destructor
+//
+// 100 million integers to /dev/null (benchmarks/bench-fast-io.cpp --bulk, GCC 12):
+// printf 68 ns/line, unsynced cout 46 ns/line, FastWriter 10 ns/line. libstdc++'s
+// std::to_chars uses the same digit-pair technique and runs at the same speed; the
+// table is spelled out here because not every standard library does.
+//
+// Not thread-safe, and unaware of stdio: don't interleave it with printf/cout on the
+// same descriptor without flushing both sides.
+#pragma once
+
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include <unistd.h>
+
+// "00" "01" … "99" — index with 2 * (value % 100)
+inline constexpr char DIGIT_PAIRS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Decimal digits of 'value' (1 for 0): bit_width * log10(2) ≈ bit_width * 1233 / 4096
+// is the digit count or one too many, and a single compare tells which
+inline int decimal_digits(std::uint64_t value)
+{
+    static constexpr std::uint64_t POWERS_OF_10[20] = {
+        0, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+        10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+        1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+        10000000000000000000ULL };
+
+    int guess = (std::bit_width(value | 1) * 1233) >> 12;
+    return guess + 1 - (value < POWERS_OF_10[guess]);
+}
+
+// Writes exactly decimal_digits(value) characters at 'out', returns the end
+inline char* format_decimal(char* out, std::uint64_t value)
+{
+    char* end    = out + decimal_digits(value);
+    char* cursor = end;
+    while (value >= 100)
+    {
+        std::size_t pair = std::size_t(value % 100) * 2;
+        value /= 100;
+        cursor -= 2;
+        std::memcpy(cursor, DIGIT_PAIRS + pair, 2);
+    }
+    if (value >= 10)
+        std::memcpy(cursor - 2, DIGIT_PAIRS + value * 2, 2);
+    else
+        cursor[-1] = char('0' + value);
+    return end;
+}
+
+class FastWriter
+{
+    static constexpr std::size_t MAX_FORMATTED = 32;   // longest integer or shortest double
+
+    int                     fd;
+    std::unique_ptr<char[]> buffer;
+    char*                   cursor;
+    char*                   limit;
+    bool                    failed = false;
+
+    void write_all(const char* data, std::size_t size)
+    {
+        const char* end = data + size;
+        while (data < end && !failed)
+        {
+            ssize_t written = ::write(fd, data, std::size_t(end - data));
+            if (written > 0)
+                data += written;
+            else if (written < 0 && errno != EINTR)
+                failed = true;   // EBADF, EPIPE, ENOSPC …: the rest is dropped
+        }
+    }
+
+    // Room for 'size' more bytes (at most the capacity); flushes when the buffer
+    // can't take them
+    char* room(std::size_t size)
+    {
+        if (std::size_t(limit - cursor) < size)
+            flush();
+        return cursor;
+    }
+
+public:
+    // The capacity is at least 4 KiB, enough for any single formatted value
+    explicit FastWriter(int fd = STDOUT_FILENO, std::size_t capacity = 1 << 20)
+        : fd(fd)
+    {
+        capacity = capacity < 4096 ? 4096 : capacity;
+        buffer.reset(new char[capacity]);
+        cursor = buffer.get();
+        limit  = cursor + capacity;
+    }
+
+    ~FastWriter() { flush(); }
+
+    FastWriter(const FastWriter&)            = delete;
+    FastWriter& operator=(const FastWriter&) = delete;
+
+    // One write(2) for the whole buffer (more only if the kernel takes it in parts)
+    bool flush()
+    {
+        write_all(buffer.get(), std::size_t(cursor - buffer.get()));
+        cursor = buffer.get();
+        return !failed;
+    }
+
+    bool ok() const { return !failed; }
+
+    void put(char c)
+    {
+        *room(1) = c;
+        ++cursor;
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        if (size > std::size_t(limit - buffer.get()) / 2)
+        {
+            // Large blocks go straight out instead of being copied through the buffer
+            flush();
+            write_all(data, size);
+            return;
+        }
+        std::memcpy(room(size), data, size);
+        cursor += size;
+    }
+
+    void write(std::string_view text) { write(text.data(), text.size()); }
+
+    void write_uint(std::uint64_t value) { cursor = format_decimal(room(20), value); }
+
+    void write_int(std::int64_t value)
+    {
+        char* out = room(21);
+        // Negate as unsigned: -INT64_MIN overflows int64_t
+        std::uint64_t magnitude = std::uint64_t(value);
+        if (value < 0)
+        {
+            *out++    = '-';
+            magnitude = 0 - magnitude;
+        }
+        cursor = format_decimal(out, magnitude);
+    }
+
+    // Shortest text that reads back as the same value ("0.1", "1e+100")
+    void write_double(double value)
+    {
+        char* out = room(MAX_FORMATTED);
+        cursor    = std::to_chars(out, out + MAX_FORMATTED, value).ptr;
+    }
+
+    // Shortest for float precision: 0.1f is "0.1", not "0.10000000149011612"
+    void write_float(float value)
+    {
+        char* out = room(MAX_FORMATTED);
+        cursor    = std::to_chars(out, out + MAX_FORMATTED, value).ptr;
+    }
+
+    // Fixed notation with 'precision' decimals (capped at 100); 1e308 has 309 integer
+    // digits, so this reserves for the worst case rather than MAX_FORMATTED
+    void write_fixed(double value, int precision)
+    {
+        precision          = precision < 0 ? 0 : precision > 100 ? 100 : precision;
+        std::size_t needed = 312 + std::size_t(precision);
+        char*       out    = room(needed);
+        cursor             = std::to_chars(out, out + needed, value, std::chars_format::fixed, precision).ptr;
+    }
+
+    // Direct access for custom formatting: write at most 'size' bytes at the returned
+    // pointer, then pass the end to commit(). 'size' can be up to the capacity (the
+    // constructor's, at least 4 KiB); nullptr for more
+    char* reserve(std::size_t size)
+    {
+        return size <= std::size_t(limit - buffer.get()) ? room(size) : nullptr;
+    }
+    void  commit(char* end) { cursor = end; }
+
+    FastWriter& operator<<(char c) { put(c); return *this; }
+    FastWriter& operator<<(std::string_view text) { write(text); return *this; }
+    FastWriter& operator<<(const char* text) { write(std::string_view(text)); return *this; }
+    FastWriter& operator<<(double value) { write_double(value); return *this; }
+    FastWriter& operator<<(float value) { write_float(value); return *this; }
+
+    template<typename Int, std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, char>
+                                            && !std::is_same_v<Int, bool>, int> = 0>
+    FastWriter& operator<<(Int value)
+    {
+        if constexpr (std::is_signed_v<Int>)
+            write_int(value);
+        else
+            write_uint(value);
+        return *this;
+    }
+};
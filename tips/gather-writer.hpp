@@ -0,0 +1,248 @@
+// Gather writer — batch output fragments and write them with one writev(2)
+//
+// Batching by concatenation (file-handling.md "Batch Writes", FastWriter) copies every
+// byte into a buffer before the write copies it again into the kernel. When the data
+// already sits in memory — log records, serialized messages, file chunks — writev can
+// take the fragments where they are: GatherWriter collects (pointer, length) pairs and
+// hands up to IOV_MAX of them to the kernel in one system call.
+//
+//   GatherWriter out(fd, { .max_bytes = 256 << 10, .max_delay = std::chrono::milliseconds(5) });
+//   out.append_copy(header);     // short-lived bytes: copied into a small arena
+//   out.append(record.body);     // referenced, not copied — must stay valid until flushed
+//   ...
+//   out.poll();                  // from the event loop / timer: applies max_delay when idle
+//
+// Flush policy — whichever comes first:
+//
+//   size      max_bytes pending (default 1 MiB)
+//   count     max_fragments pending (default and ceiling: the system's IOV_MAX, 1024 on Linux)
+//   arena     the copy arena is full (copy_capacity, default 1 MiB)
+//   latency   the oldest pending fragment is max_delay old (0 = off); checked on every
+//             16th append and by poll(), so an idle writer needs poll() to be called
+//
+// Referenced fragments must stay valid until the next flush: flush() returning, or
+// statistics().flushes changing, is the point where the caller may reuse them.
+// Fragments under copy_below bytes (default 512) are copied anyway — writev costs the
+// kernel more per iovec than memcpy costs for a short string — and adjacent fragments
+// (consecutive copies, consecutive slices of one buffer) are merged into one iovec.
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct t_GatherPolicy
+{
+    std::size_t               max_bytes     = 1 << 20;
+    std::size_t               max_fragments = 0;         // 0: IOV_MAX
+    std::chrono::microseconds max_delay{ 0 };            // 0: no latency bound
+    std::size_t               copy_capacity = 1 << 20;   // arena for append_copy()
+    std::size_t               copy_below    = 512;       // append() copies smaller fragments
+};
+
+struct t_GatherStats
+{
+    std::uint64_t syscalls      = 0;   // writev calls, including retries after partial writes
+    std::uint64_t flushes       = 0;
+    std::uint64_t fragments     = 0;   // iovecs handed to the kernel
+    std::uint64_t bytes_written = 0;
+    std::uint64_t bytes_copied  = 0;   // by append_copy()
+};
+
+class GatherWriter
+{
+    int                     fd;
+    t_GatherPolicy          policy;
+    std::vector<iovec>      fragments;
+    std::size_t             pending_bytes = 0;
+    std::unique_ptr<char[]> arena;
+    std::size_t             arena_used    = 0;
+    std::chrono::steady_clock::time_point oldest;      // when the first pending fragment arrived
+    unsigned                appends       = 0;
+    bool                    failed        = false;
+    t_GatherStats           stats;
+
+    static std::size_t system_iov_max()
+    {
+        long limit = ::sysconf(_SC_IOV_MAX);
+#if defined(IOV_MAX)
+        return limit > 0 ? std::size_t(limit) : IOV_MAX;
+#else
+        return limit > 0 ? std::size_t(limit) : 16;   // the POSIX minimum
+#endif
+    }
+
+    // writev until every byte is out; partial writes advance through the iovecs
+    void write_fragments(iovec* first, iovec* last)
+    {
+        const std::size_t iov_max = system_iov_max();
+        while (first < last && !failed)
+        {
+            int     count   = int(std::min<std::size_t>(std::size_t(last - first), iov_max));
+            ssize_t written = ::writev(fd, first, count);
+            stats.syscalls++;
+            if (written < 0)
+            {
+                if (errno != EINTR)
+                    failed = true;   // EBADF, EPIPE, ENOSPC …: the rest is dropped
+                continue;
+            }
+            stats.bytes_written += std::uint64_t(written);
+            for (std::size_t left = std::size_t(written); left > 0 || (first < last && first->iov_len == 0);)
+            {
+                if (left >= first->iov_len)
+                {
+                    left -= first->iov_len;
+                    ++first;
+                }
+                else
+                {
+                    first->iov_base = static_cast<char*>(first->iov_base) + left;
+                    first->iov_len -= left;
+                    left = 0;
+                }
+            }
+        }
+    }
+
+    void add(const void* data, std::size_t size)
+    {
+        if (fragments.empty())
+        {
+            if (policy.max_delay.count() > 0)
+                oldest = std::chrono::steady_clock::now();
+        }
+        else if (static_cast<char*>(fragments.back().iov_base) + fragments.back().iov_len == data)
+        {
+            fragments.back().iov_len += size;   // continues the previous fragment
+            pending_bytes += size;
+            return;
+        }
+        fragments.push_back({ const_cast<void*>(data), size });
+        pending_bytes += size;
+    }
+
+    void apply_policy()
+    {
+        if (pending_bytes >= policy.max_bytes || fragments.size() >= policy.max_fragments)
+            flush();
+        else if (policy.max_delay.count() > 0 && (++appends & 15) == 0 && !fragments.empty()
+                 && std::chrono::steady_clock::now() - oldest >= policy.max_delay)
+            flush();
+    }
+
+public:
+    explicit GatherWriter(int fd = STDOUT_FILENO, t_GatherPolicy gather_policy = {})
+        : fd(fd), policy(gather_policy)
+    {
+        std::size_t iov_max  = system_iov_max();
+        policy.max_fragments = policy.max_fragments ? std::min(policy.max_fragments, iov_max) : iov_max;
+        policy.copy_capacity = std::max<std::size_t>(policy.copy_capacity, 4096);
+        arena.reset(new char[policy.copy_capacity]);
+        fragments.reserve(policy.max_fragments);
+    }
+
+    ~GatherWriter() { flush(); }
+
+    GatherWriter(const GatherWriter&)            = delete;
+    GatherWriter& operator=(const GatherWriter&) = delete;
+
+    // Referenced: the bytes must stay valid until the next flush. Fragments shorter
+    // than copy_below are copied instead — the kernel's cost per iovec is higher than
+    // a memcpy of a few hundred bytes
+    void append(std::string_view text)
+    {
+        if (text.size() < policy.copy_below)
+            return append_copy(text);
+        add(text.data(), text.size());
+        apply_policy();
+    }
+
+    void append(std::span<const std::byte> bytes)
+    {
+        append(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+    }
+
+    // Copied into the arena: for temporaries and formatted headers
+    void append_copy(std::string_view text)
+    {
+        if (text.empty())
+            return;
+        if (text.size() > policy.copy_capacity - arena_used)
+        {
+            flush();   // frees the arena
+            if (text.size() > policy.copy_capacity)
+            {
+                add(text.data(), text.size());   // too big to copy: write it before returning
+                flush();
+                return;
+            }
+        }
+        char* copy = arena.get() + arena_used;
+        std::memcpy(copy, text.data(), text.size());
+        arena_used += text.size();
+        stats.bytes_copied += text.size();
+        add(copy, text.size());
+        apply_policy();
+    }
+
+    // Room for up to 'size' bytes in the arena, to format into directly; commit() what was used
+    char* reserve(std::size_t size)
+    {
+        if (size > policy.copy_capacity - arena_used)
+            flush();
+        return size <= policy.copy_capacity ? arena.get() + arena_used : nullptr;
+    }
+
+    void commit(char* end)
+    {
+        char*       copy = arena.get() + arena_used;
+        std::size_t size = std::size_t(end - copy);
+        if (size == 0)
+            return;
+        arena_used += size;
+        stats.bytes_copied += size;
+        add(copy, size);
+        apply_policy();
+    }
+
+    // The latency policy for a writer that receives nothing new; true if it flushed
+    bool poll()
+    {
+        if (fragments.empty() || policy.max_delay.count() == 0
+            || std::chrono::steady_clock::now() - oldest < policy.max_delay)
+            return false;
+        flush();
+        return true;
+    }
+
+    // Writes everything pending; afterwards referenced fragments may be reused
+    bool flush()
+    {
+        if (!fragments.empty())
+        {
+            stats.flushes++;
+            stats.fragments += fragments.size();
+            write_fragments(fragments.data(), fragments.data() + fragments.size());
+            fragments.clear();
+        }
+        pending_bytes = 0;
+        arena_used    = 0;
+        return !failed;
+    }
+
+    bool                 ok() const { return !failed; }
+    std::size_t          pending() const { return pending_bytes; }
+    const t_GatherStats& statistics() const { return stats; }
+};
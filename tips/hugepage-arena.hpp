@@ -0,0 +1,169 @@
+// Huge-page arena — one big reserved range, committed lazily, backed by 2 MiB pages
+//
+// Arena<> (arena-allocator.hpp) chains chunks from malloc or mmap, all mapped with
+// 4 KiB pages. A large in-memory index touched at random then misses the TLB on
+// almost every lookup: 1 GiB of 4 KiB pages is 262144 translations, 2 MiB pages
+// need only 512.
+//
+// HugePageArena keeps the same bump-pointer API but:
+//
+//   - reserves the whole capacity up front with mmap(PROT_NONE) — address space only,
+//     no RAM and no overcommit charge
+//   - aligns the range to 2 MiB and asks for transparent huge pages with
+//     madvise(MADV_HUGEPAGE)
+//   - commits (mprotect read/write) in 2 MiB steps only as the cursor reaches them;
+//     physical pages still arrive on first touch
+//
+// If THP is compiled out or set to "never", madvise fails or is ignored and the arena
+// quietly runs on 4 KiB pages — huge_pages() tells which one you got.
+//
+//   [ committed, in use | committed | reserved PROT_NONE .................... ]
+//   base            cursor      committed                                     end
+#pragma once
+
+#include "arena-allocator.hpp"   // t_ArenaMarker, t_ArenaScope
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+
+enum class t_PageMode
+{
+    Huge,    // MADV_HUGEPAGE, falls back to 4 KiB pages when THP is unavailable
+    Small    // MADV_NOHUGEPAGE — force 4 KiB pages, e.g. for comparison
+};
+
+// "always [madvise] never" → true unless "[never]" is selected (or the file is missing)
+inline bool thp_enabled()
+{
+    std::FILE* file = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!file)
+        return false;
+
+    char line[128] = {};
+    bool enabled   = std::fgets(line, sizeof(line), file) && !std::strstr(line, "[never]");
+    std::fclose(file);
+    return enabled;
+}
+
+class HugePageArena
+{
+    static constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    char* base      = nullptr;
+    char* cursor    = nullptr;
+    char* committed = nullptr;   // [base, committed) is read/write
+    char* end       = nullptr;   // [committed, end) is reserved PROT_NONE
+    bool  huge      = false;
+
+    static std::size_t round_up(std::size_t size, std::size_t align) { return (size + align - 1) & ~(align - 1); }
+
+    static char* align_up(char* ptr, std::size_t align)
+    {
+        std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+        return reinterpret_cast<char*>((p + align - 1) & ~std::uintptr_t(align - 1));
+    }
+
+    // Slow path: extend the committed range to cover 'new_cursor'
+    void commit(char* new_cursor)
+    {
+        if (new_cursor > end)
+            throw std::bad_alloc();
+
+        char* new_committed = align_up(new_cursor, HUGE_PAGE);
+        if (::mprotect(committed, std::size_t(new_committed - committed), PROT_READ | PROT_WRITE) != 0)
+            throw std::bad_alloc();
+        committed = new_committed;
+    }
+
+public:
+    // 'capacity' is address space, not memory — reserving many GiB is fine
+    explicit HugePageArena(std::size_t capacity, t_PageMode mode = t_PageMode::Huge)
+    {
+        std::size_t size = round_up(capacity, HUGE_PAGE);
+
+        // Over-reserve by one huge page so the range can be trimmed to 2 MiB alignment:
+        // the kernel only backs aligned 2 MiB ranges with a huge page
+        void* raw = ::mmap(nullptr, size + HUGE_PAGE, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc();
+
+        char* first = static_cast<char*>(raw);
+        base        = align_up(first, HUGE_PAGE);
+        end         = base + size;
+        if (base != first)
+            ::munmap(first, std::size_t(base - first));
+        if (first + size + HUGE_PAGE != end)
+            ::munmap(end, std::size_t(first + size + HUGE_PAGE - end));
+
+        cursor    = base;
+        committed = base;
+
+        // The advice sticks to the range, including pages committed later.
+        // EINVAL means the kernel was built without THP — keep going on 4 KiB pages.
+        if (mode == t_PageMode::Huge)
+            huge = ::madvise(base, size, MADV_HUGEPAGE) == 0 && thp_enabled();
+        else
+            ::madvise(base, size, MADV_NOHUGEPAGE);
+    }
+
+    ~HugePageArena() { ::munmap(base, std::size_t(end - base)); }
+
+    // The arena owns one mapping — copying would double-unmap it
+    HugePageArena(const HugePageArena&)            = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // Fast path: align, compare, bump — the commit check only fails once per 2 MiB
+    void* alloc(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        char* aligned = align_up(cursor, align);
+        if (size > std::size_t(end - aligned))
+            throw std::bad_alloc();
+
+        char* new_cursor = aligned + size;
+        if (new_cursor > committed)
+            commit(new_cursor);
+
+        cursor = new_cursor;
+        return aligned;
+    }
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        return new (alloc(sizeof(T), alignof(T))) T(static_cast<Args&&>(args)...);
+    }
+
+    // Markers share Arena's type so t_ArenaScope works unchanged (chunk is unused)
+    t_ArenaMarker checkpoint() const { return { nullptr, cursor }; }
+    void          rewind(t_ArenaMarker marker) { cursor = marker.cursor; }
+    void          reset() { cursor = base; }
+
+    // Give committed pages past the cursor back to the kernel and re-protect them
+    void trim()
+    {
+        char* keep = align_up(cursor, HUGE_PAGE);
+        if (keep == committed)
+            return;
+
+        ::madvise(keep, std::size_t(committed - keep), MADV_DONTNEED);
+        ::mprotect(keep, std::size_t(committed - keep), PROT_NONE);
+        committed = keep;
+    }
+
+    std::size_t used() const { return std::size_t(cursor - base); }
+    std::size_t committed_bytes() const { return std::size_t(committed - base); }
+    std::size_t capacity() const { return std::size_t(end - base); }
+    bool        huge_pages() const { return huge; }
+
+    void print_usage(const char* label = "HugePageArena") const
+    {
+        std::printf("[%s]  used=%zu bytes  committed=%zu bytes  reserved=%zu bytes  pages=%s\n",
+                    label, used(), committed_bytes(), capacity(), huge ? "2 MiB (THP)" : "4 KiB");
+    }
+};
@@ -0,0 +1,389 @@
+// O(1) leak registry — hash-indexed replacement for the Level 7 linear scan
+//
+// Level 7 of Memory_allocation_debugging.md walks all 65,536 registry slots on every
+// allocation and every free. This version keys live allocations by pointer in an
+// open-addressing hash table:
+//   - backed by malloc/free only — no STL, no operator new inside the hooks
+//   - linear probing, grows (doubles) when the load factor passes 1/2
+//   - backward-shift deletion — no tombstones, so probe chains never rot
+//   - one spinlock, so it is safe to allocate from several threads
+//
+// Compile: g++ -std=c++17 -O2 -fno-allocation-dce leak-registry.cpp -o leak-registry
+// Run    : ./leak-registry          (leak report demo)
+//          ./leak-registry --bench  (throughput with 1M live objects)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------
+// t_AllocRecord — one entry per live allocation (ptr == nullptr → empty slot)
+// ---------------------------------------------------------------
+struct t_AllocRecord
+{
+    void*       ptr  = nullptr;
+    std::size_t size = 0;
+    const char* file = nullptr;
+    int         line = 0;
+};
+
+// ---------------------------------------------------------------
+// t_SpinLock — a mutex that never allocates
+// ---------------------------------------------------------------
+struct t_SpinLock
+{
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    void lock()   { while (flag.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag.clear(std::memory_order_release); }
+};
+
+// ---------------------------------------------------------------
+// LeakRegistry — pointer → record, open addressing, malloc-backed
+//
+// Every member is trivially initialized, so a static LeakRegistry is ready
+// before any static constructor gets a chance to call operator new.
+// ---------------------------------------------------------------
+class LeakRegistry
+{
+    t_AllocRecord* slots    = nullptr;
+    std::size_t    capacity = 0;        // always a power of two (or 0)
+    std::size_t    live     = 0;
+    t_SpinLock     mutex;
+
+    static constexpr std::size_t INITIAL_CAPACITY = 1024;
+
+    // Fibonacci hashing: allocations are 16-byte aligned, so the low bits carry
+    // no information — multiply and keep the high bits instead.
+    std::size_t home_slot(const void* ptr) const
+    {
+        std::uint64_t h = std::uint64_t(reinterpret_cast<std::uintptr_t>(ptr)) * 0x9E3779B97F4A7C15ull;
+        return std::size_t(h >> 32) & (capacity - 1);
+    }
+
+    // Insert without growing — caller guarantees there is a free slot
+    void place(const t_AllocRecord& record)
+    {
+        std::size_t i = home_slot(record.ptr);
+        while (slots[i].ptr)
+            i = (i + 1) & (capacity - 1);
+        slots[i] = record;
+    }
+
+    bool grow()
+    {
+        std::size_t    new_capacity = capacity ? capacity * 2 : INITIAL_CAPACITY;
+        t_AllocRecord* new_slots    = static_cast<t_AllocRecord*>(std::calloc(new_capacity, sizeof(t_AllocRecord)));
+        if (!new_slots)
+            return false;
+
+        t_AllocRecord* old_slots    = slots;
+        std::size_t    old_capacity = capacity;
+
+        slots    = new_slots;
+        capacity = new_capacity;
+        for (std::size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_slots[i].ptr)
+                place(old_slots[i]);
+        }
+        std::free(old_slots);
+        return true;
+    }
+
+public:
+    void add(void* ptr, std::size_t size, const char* file, int line)
+    {
+        mutex.lock();
+        if ((live + 1) * 2 > capacity && !grow())
+        {
+            mutex.unlock();
+            std::printf("[registry] WARNING: out of memory, allocation not tracked.\n");
+            return;
+        }
+        place({ ptr, size, file, line });
+        live++;
+        mutex.unlock();
+    }
+
+    void remove(void* ptr)
+    {
+        mutex.lock();
+        if (capacity == 0)
+        {
+            mutex.unlock();
+            return;
+        }
+
+        std::size_t mask = capacity - 1;
+        std::size_t i    = home_slot(ptr);
+        while (slots[i].ptr && slots[i].ptr != ptr)
+            i = (i + 1) & mask;
+
+        if (!slots[i].ptr)   // not ours (allocated before tracking or by malloc)
+        {
+            mutex.unlock();
+            return;
+        }
+
+        // Backward-shift deletion: pull later members of the probe chain into the
+        // hole as long as that does not move them in front of their home slot.
+        std::size_t hole = i;
+        std::size_t next = (hole + 1) & mask;
+        while (slots[next].ptr)
+        {
+            std::size_t home = home_slot(slots[next].ptr);
+            // distance(home → next) >= distance(hole → next) means the entry
+            // may legally live at 'hole'
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                slots[hole] = slots[next];
+                hole        = next;
+            }
+            next = (next + 1) & mask;
+        }
+        slots[hole] = t_AllocRecord{};
+        live--;
+        mutex.unlock();
+    }
+
+    std::size_t live_count() const { return live; }
+
+    void print_leaks()
+    {
+        mutex.lock();
+        std::printf("\n========== LEAK REPORT ==========\n");
+        std::size_t leak_count = 0;
+        std::size_t leak_bytes = 0;
+
+        for (std::size_t i = 0; i < capacity; i++)
+        {
+            if (slots[i].ptr)
+            {
+                leak_count++;
+                leak_bytes += slots[i].size;
+                std::printf("  LEAK  %5zu bytes  →  %s:%d\n",
+                            slots[i].size,
+                            slots[i].file ? slots[i].file : "<unknown>",
+                            slots[i].line);
+            }
+        }
+
+        if (leak_count == 0)
+            std::printf("  No leaks detected.\n");
+        else
+            std::printf("  %zu leak(s) found, %zu bytes.\n", leak_count, leak_bytes);
+
+        std::printf("=================================\n");
+        mutex.unlock();
+    }
+};
+
+static LeakRegistry g_registry;
+static bool         g_tracking_enabled = true;   // flipped off by the benchmark baseline
+
+// ---------------------------------------------------------------
+// Hooks — the file/line overload for our own code, the plain one for everything else
+// ---------------------------------------------------------------
+void* operator new(std::size_t size, const char* file, int line)
+{
+    void* ptr = std::malloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    if (g_tracking_enabled)
+        g_registry.add(ptr, size, file, line);
+    return ptr;
+}
+
+void* operator new(std::size_t size)
+{
+    return ::operator new(size, nullptr, 0);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+    if (g_tracking_enabled)
+        g_registry.remove(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept             { ::operator delete(ptr); }
+void operator delete(void* ptr, const char* /*file*/, int /*line*/) noexcept { ::operator delete(ptr); }
+
+void* operator new[](std::size_t size, const char* file, int line) { return ::operator new(size, file, line); }
+void* operator new[](std::size_t size)                             { return ::operator new(size); }
+
+void operator delete[](void* ptr) noexcept                              { ::operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept        { ::operator delete(ptr); }
+void operator delete[](void* ptr, const char* file, int line) noexcept  { ::operator delete(ptr, file, line); }
+
+// ---------------------------------------------------------------
+// Benchmark — allocation throughput with 1M live objects
+// ---------------------------------------------------------------
+struct t_Node
+{
+    std::uint64_t payload[4];
+};
+
+// The Level 7 registry from the guide, kept only for comparison
+struct t_LinearRegistry
+{
+    static constexpr int MAX_TRACKED = 65536;
+
+    struct t_Slot { void* ptr; std::size_t size; bool used; };
+    t_Slot slots[MAX_TRACKED] = {};
+
+    void add(void* ptr, std::size_t size)
+    {
+        for (int i = 0; i < MAX_TRACKED; i++)
+        {
+            if (!slots[i].used)
+            {
+                slots[i] = { ptr, size, true };
+                return;
+            }
+        }
+    }
+
+    void remove(void* ptr)
+    {
+        for (int i = 0; i < MAX_TRACKED; i++)
+        {
+            if (slots[i].used && slots[i].ptr == ptr)
+            {
+                slots[i].used = false;
+                return;
+            }
+        }
+    }
+};
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Fill 'live' objects, then replace random ones 'churn' times
+static void bench_registry(const char* label, std::size_t live, std::size_t churn)
+{
+    std::vector<t_Node*> objects(live);   // allocated before timing starts
+    std::mt19937_64      rng(42);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < live; i++)
+        objects[i] = new t_Node();
+    double fill = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < churn; i++)
+    {
+        std::size_t victim = rng() % live;
+        delete objects[victim];
+        objects[victim] = new t_Node();
+    }
+    double replace = seconds_since(start);
+
+    for (t_Node* node : objects)
+        delete node;
+
+    std::printf("%-22s  live=%-8zu  fill %6.1f M allocs/s   churn %6.1f M new+delete/s\n",
+                label, live, live / fill / 1e6, churn / replace / 1e6);
+}
+
+static void bench_linear(std::size_t live, std::size_t churn)
+{
+    t_LinearRegistry*    registry = new t_LinearRegistry();
+    std::vector<t_Node*> objects(live);
+    std::mt19937_64      rng(42);
+
+    g_tracking_enabled = false;
+    for (std::size_t i = 0; i < live; i++)
+    {
+        objects[i] = new t_Node();
+        registry->add(objects[i], sizeof(t_Node));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < churn; i++)
+    {
+        std::size_t victim = rng() % live;
+        registry->remove(objects[victim]);
+        delete objects[victim];
+        objects[victim] = new t_Node();
+        registry->add(objects[victim], sizeof(t_Node));
+    }
+    double replace = seconds_since(start);
+
+    for (t_Node* node : objects)
+        delete node;
+    delete registry;
+    g_tracking_enabled = true;
+
+    std::printf("%-22s  live=%-8zu  %-28s churn %6.3f M new+delete/s\n",
+                "linear scan (Level 7)", live, "", churn / replace / 1e6);
+}
+
+static void run_benchmark()
+{
+    constexpr std::size_t LIVE  = 1'000'000;
+    constexpr std::size_t CHURN = 2'000'000;
+
+    g_tracking_enabled = false;
+    bench_registry("untracked malloc", LIVE, CHURN);
+    g_tracking_enabled = true;
+    bench_registry("hash registry", LIVE, CHURN);
+
+    // The linear registry caps at 65,536 entries and needs O(n) per operation
+    bench_linear(50'000, 20'000);
+    bench_registry("hash registry", 50'000, CHURN);
+}
+
+// ---------------------------------------------------------------
+// Redirect 'new' — include ALL headers ABOVE this line!
+// ---------------------------------------------------------------
+#define new new(__FILE__, __LINE__)
+
+// ---------------------------------------------------------------
+// Usage
+// ---------------------------------------------------------------
+class Weapon
+{
+public:
+    int   damage;
+    float range;
+
+    Weapon(int d, float r) : damage(d), range(r) {}
+};
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        run_benchmark();
+        return 0;
+    }
+
+    int*    a = new int(1);
+    int*    b = new int(2);
+    Weapon* w = new Weapon(50, 100.0f);
+
+    delete a;   // freed — removed from registry in O(1)
+
+    // b and w are intentionally NOT deleted — demonstrates leak detection
+    (void)b;
+    (void)w;
+
+    g_registry.print_leaks();
+    return 0;
+}
+
+#undef new
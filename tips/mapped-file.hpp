@@ -0,0 +1,236 @@
+// Memory-mapped file — read a large file without copying it into a buffer
+//
+// ifstream::read copies every byte from the page cache into your string; getline
+// copies it again into a std::string per line. mmap makes the page cache itself
+// visible in the address space: no copy, no allocation, and pages the program never
+// touches are never read.
+//
+//   MappedFile file("huge.log");                      // throws std::system_error
+//   std::span<const std::byte> bytes = file.bytes();
+//   for (std::string_view line : file.lines())        // no allocation per line
+//       handle(line);
+//
+// Options:
+//
+//   access    madvise hint for the kernel's readahead — Sequential (read ahead
+//             aggressively, drop pages behind), Random (read only the faulting page),
+//             Normal (the kernel's default heuristics)
+//   populate  MAP_POPULATE: fault every page in during mmap() itself, so the scan
+//             runs without page faults; costs the whole read up front
+//
+// Linux/POSIX only. The mapping is read-only and MAP_PRIVATE: if another process
+// truncates the file while it is mapped, touching the lost pages raises SIGBUS.
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class t_Access
+{
+    Normal,       // MADV_NORMAL
+    Sequential,   // MADV_SEQUENTIAL
+    Random        // MADV_RANDOM
+};
+
+struct t_MapOptions
+{
+    t_Access access   = t_Access::Sequential;
+    bool     populate = false;
+};
+
+// ---------------------------------------------------------------
+// Lines of a mapping, as string_views without the '\n'
+// ---------------------------------------------------------------
+// Same lines as std::getline: a final line without '\n' is still a line, a trailing
+// '\n' doesn't add an empty one, and '\r' is kept.
+class t_LineRange
+{
+    const char* first;
+    const char* last;
+
+public:
+    class iterator
+    {
+        const char*      next;   // start of the line after 'line'
+        const char*      last;
+        std::string_view line;
+        bool             done;
+
+        void advance()
+        {
+            if (next == last)
+            {
+                done = true;
+                return;
+            }
+            const void* newline = std::memchr(next, '\n', std::size_t(last - next));   // vectorized in libc
+            const char* stop    = newline ? static_cast<const char*>(newline) : last;
+            line                = std::string_view(next, std::size_t(stop - next));
+            next                = newline ? stop + 1 : last;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string_view*;
+        using reference         = const std::string_view&;
+
+        iterator() : next(nullptr), last(nullptr), done(true) {}
+        iterator(const char* first, const char* last) : next(first), last(last), done(false) { advance(); }
+
+        reference operator*() const { return line; }
+        pointer   operator->() const { return &line; }
+
+        iterator& operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator copy = *this;
+            advance();
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return done == other.done && (done || line.data() == other.line.data());
+        }
+    };
+
+    t_LineRange(const char* first, const char* last) : first(first), last(last) {}
+
+    iterator begin() const { return iterator(first, last); }
+    iterator end() const { return iterator(); }
+};
+
+// ---------------------------------------------------------------
+// MappedFile
+// ---------------------------------------------------------------
+class MappedFile
+{
+    std::byte*  data = nullptr;
+    std::size_t size = 0;
+
+    static int advice_for(t_Access access)
+    {
+        switch (access)
+        {
+        case t_Access::Sequential: return MADV_SEQUENTIAL;
+        case t_Access::Random: return MADV_RANDOM;
+        default: return MADV_NORMAL;
+        }
+    }
+
+    void unmap()
+    {
+        if (data)
+            ::munmap(data, size);
+        data = nullptr;
+        size = 0;
+    }
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const char* path, t_MapOptions options = {})
+    {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+
+        size = std::size_t(info.st_size);
+        if (size > 0)   // mmap of length 0 is an error; an empty file is an empty span
+        {
+            int   flags  = MAP_PRIVATE | (options.populate ? MAP_POPULATE : 0);
+            void* mapped = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+            data = static_cast<std::byte*>(mapped);
+            advise(options.access);
+        }
+        ::close(fd);   // the mapping keeps its own reference to the file
+    }
+
+    explicit MappedFile(const std::string& path, t_MapOptions options = {}) : MappedFile(path.c_str(), options) {}
+
+    ~MappedFile() { unmap(); }
+
+    MappedFile(MappedFile&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0))
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> bytes() const { return { data, size }; }
+    std::string_view           text() const { return { reinterpret_cast<const char*>(data), size }; }
+    t_LineRange                lines() const { return { text().data(), text().data() + size }; }
+
+    std::size_t length() const { return size; }
+    bool        empty() const { return size == 0; }
+
+    // Change the readahead hint for the whole file or one part of it, e.g. Random for
+    // an index section and Sequential for the data after it
+    void advise(t_Access access, std::size_t offset = 0, std::size_t length = std::size_t(-1))
+    {
+        if (!data || offset >= size)
+            return;
+        // madvise needs a page-aligned start
+        std::size_t page  = std::size_t(::sysconf(_SC_PAGESIZE));
+        std::size_t start = offset & ~(page - 1);
+        std::size_t stop  = length > size - offset ? size : offset + length;
+        ::madvise(data + start, stop - start, advice_for(access));
+    }
+
+    // Start reading [offset, offset + length) in the background (MADV_WILLNEED) —
+    // a lighter MAP_POPULATE for the part that will be needed next
+    void prefetch(std::size_t offset, std::size_t length)
+    {
+        if (!data || offset >= size)
+            return;
+        std::size_t page  = std::size_t(::sysconf(_SC_PAGESIZE));
+        std::size_t start = offset & ~(page - 1);
+        std::size_t stop  = length > size - offset ? size : offset + length;
+        ::madvise(data + start, stop - start, MADV_WILLNEED);
+    }
+};
@@ -0,0 +1,170 @@
+// std::pmr containers on top of PoolAllocator, Arena and SlabAllocator
+//
+// Compile: g++ -std=c++17 -O2 pmr-resources.cpp -o pmr-resources
+// Run    : ./pmr-resources          (containers demo)
+//          ./pmr-resources --bench  (100k-string map: new_delete_resource vs pools)
+
+#include "arena-allocator.hpp"
+#include "pmr-resources.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------
+// PoolAllocator<PoolSize> — the fixed bump allocator from the guide (Level 8 A)
+// ---------------------------------------------------------------
+template<std::size_t PoolSize>
+class PoolAllocator
+{
+    alignas(std::max_align_t) char pool[PoolSize];
+    std::size_t offset = 0;
+
+public:
+    void* alloc(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        std::size_t aligned_offset = (offset + align - 1) & ~(align - 1);
+
+        // Under pmr, return nullptr instead of asserting: t_BumpResource turns it
+        // into std::bad_alloc, which containers know how to handle
+        if (aligned_offset + size > PoolSize)
+            return nullptr;
+
+        offset = aligned_offset + size;
+        return pool + aligned_offset;
+    }
+
+    void reset() { offset = 0; }
+
+    void print_usage(const char* label = "Pool") const
+    {
+        std::printf("[%s]  used=%zu / %zu bytes  (%.1f%%)\n",
+                    label, offset, PoolSize,
+                    100.0 * double(offset) / double(PoolSize));
+    }
+};
+
+// ---------------------------------------------------------------
+// Usage
+// ---------------------------------------------------------------
+static PoolAllocator<256 * 1024> g_frame_pool;   // static: too big for the stack
+
+static void run_demo()
+{
+    // 1. A frame-scoped vector of strings in the fixed pool
+    {
+        t_BumpResource<PoolAllocator<256 * 1024>> resource(g_frame_pool);
+
+        std::pmr::vector<std::pmr::string> names(&resource);
+        for (int i = 0; i < 100; i++)
+            names.emplace_back("a name long enough to skip small string optimization");
+
+        g_frame_pool.print_usage("frame pool, 100 strings");
+    }
+    g_frame_pool.reset();
+
+    // 2. An unordered_map in a growable arena — no size limit to guess up front
+    Arena<4096> arena;
+    {
+        t_BumpResource<Arena<4096>> resource(arena);
+
+        std::pmr::unordered_map<std::pmr::string, int> ages(&resource);
+        for (int i = 0; i < 10000; i++)
+            ages.emplace("user-with-a-long-identifier-" + std::to_string(i), i);
+
+        arena.print_usage("arena, 10k map entries");
+    }
+    arena.reset();
+
+    // 3. A long-lived map with churn in the slab pool — erased nodes are reused
+    t_SlabResource<> slab_resource;
+    std::pmr::unordered_map<int, std::pmr::string> cache(&slab_resource);
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+            cache.emplace(i, "cached value that lives on the heap......");
+        cache.clear();
+    }
+    SlabAllocator<>().print_usage("slab after 100 rounds of 1000 inserts");
+}
+
+// ---------------------------------------------------------------
+// Benchmark — build and tear down a map of 100k strings
+// ---------------------------------------------------------------
+using t_StringMap = std::pmr::unordered_map<std::pmr::string, std::size_t>;
+
+static std::vector<std::string> make_keys(std::size_t count)
+{
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+        keys.push_back("benchmark-key-with-heap-storage-" + std::to_string(i));
+    return keys;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 'release' runs after the map is destroyed — e.g. arena.reset()
+template<typename Release>
+static void bench_map(const char* label, std::pmr::memory_resource* resource,
+                      const std::vector<std::string>& keys, int rounds, Release release)
+{
+    double build_ms = 0, teardown_ms = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto* map  = new t_StringMap(resource);
+        for (std::size_t i = 0; i < keys.size(); i++)
+            map->emplace(keys[i], i);
+        build_ms += ms_since(start);
+
+        assert(map->size() == keys.size());
+
+        start = std::chrono::steady_clock::now();
+        delete map;
+        release();
+        teardown_ms += ms_since(start);
+    }
+    std::printf("  %-28s build %7.2f ms   teardown %7.2f ms\n",
+                label, build_ms / rounds, teardown_ms / rounds);
+}
+
+static void run_benchmark()
+{
+    constexpr int ROUNDS = 20;
+    std::vector<std::string> keys = make_keys(100'000);
+    std::printf("unordered_map<pmr::string, size_t>, %zu keys, average of %d rounds\n", keys.size(), ROUNDS);
+
+    bench_map("new_delete_resource", std::pmr::new_delete_resource(), keys, ROUNDS, [] {});
+
+    Arena<4096> arena;
+    t_BumpResource<Arena<4096>> arena_resource(arena);
+    bench_map("t_BumpResource<Arena>", &arena_resource, keys, ROUNDS, [&] { arena.reset(); });
+
+    t_SlabResource<> slab_resource;
+    bench_map("t_SlabResource", &slab_resource, keys, ROUNDS, [] {});
+
+    // Standard library equivalents, for reference
+    std::pmr::monotonic_buffer_resource monotonic;
+    bench_map("monotonic_buffer_resource", &monotonic, keys, ROUNDS, [&] { monotonic.release(); });
+
+    std::pmr::unsynchronized_pool_resource pool;
+    bench_map("unsynchronized_pool_resource", &pool, keys, ROUNDS, [] {});
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+        run_benchmark();
+    else
+        run_demo();
+    return 0;
+}
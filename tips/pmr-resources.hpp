@@ -0,0 +1,78 @@
+// std::pmr::memory_resource adapters for the guide's pools
+//
+// std::pmr containers (vector, string, unordered_map, ...) take a memory_resource*
+// at construction and send every allocation through it. These adapters let them
+// allocate from the pools in this folder:
+//
+//   t_BumpResource<Pool>  — any bump pool with alloc(size, align):
+//                           PoolAllocator<N> from the guide, or Arena<> (arena-allocator.hpp).
+//                           deallocate is a no-op; memory comes back on reset()/rewind().
+//   t_SlabResource<Tag>   — the free-list SlabAllocator (slab-allocator.hpp):
+//                           deallocate really frees, so long-lived containers don't grow.
+//
+// Requires C++17 and a standard library with <memory_resource> (GCC 9+, Clang 16+, MSVC 2017+).
+#pragma once
+
+#include "slab-allocator.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+
+// ---------------------------------------------------------------
+// t_BumpResource<Pool> — containers allocate by bumping the pool's pointer
+// ---------------------------------------------------------------
+template<typename Pool>
+class t_BumpResource : public std::pmr::memory_resource
+{
+    Pool& pool;
+
+public:
+    explicit t_BumpResource(Pool& p) : pool(p) {}
+
+    Pool& get_pool() const { return pool; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        void* ptr = pool.alloc(bytes, align);
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+    // Individual frees are ignored — the owner resets or rewinds the whole pool
+    void do_deallocate(void* /*ptr*/, std::size_t /*bytes*/, std::size_t /*align*/) override {}
+
+    // Two bump resources are interchangeable only if they share the same pool
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        const auto* rhs = dynamic_cast<const t_BumpResource*>(&other);
+        return rhs && &rhs->pool == &pool;
+    }
+};
+
+// ---------------------------------------------------------------
+// t_SlabResource<Tag> — size-class free lists; deallocate returns the block
+// ---------------------------------------------------------------
+template<typename Tag = void>
+class t_SlabResource : public std::pmr::memory_resource
+{
+    SlabAllocator<Tag> slab;
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        return slab.alloc(bytes, align);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t align) override
+    {
+        slab.free(ptr, bytes, align);
+    }
+
+    // Every SlabAllocator<Tag> shares one heap, so any two resources with the same Tag
+    // can free each other's memory
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return dynamic_cast<const t_SlabResource*>(&other) != nullptr;
+    }
+};
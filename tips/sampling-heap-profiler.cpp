@@ -0,0 +1,435 @@
+// Sampling heap profiler — a stack trace for ~1 in every 512 KiB allocated
+//
+// Level 6 of Memory_allocation_debugging.md unwinds the stack on EVERY allocation,
+// which costs microseconds per new. Production profilers (tcmalloc, jemalloc) sample
+// instead: think of every allocated byte as a coin flip with probability 1/INTERVAL.
+// The gap between two "heads" is exponentially distributed, so each thread keeps a
+// countdown of bytes drawn from that distribution:
+//
+//   operator new(size):  countdown -= size;  if (countdown > 0) → fast path, done
+//                                            else → unwind the stack, draw a new countdown
+//
+// An allocation of s bytes is sampled with probability p = 1 - exp(-s / INTERVAL), so
+// each sample is weighted by s / p bytes (and 1 / p allocations). Summed over many
+// samples this is an unbiased estimate of what every call site really allocated.
+//
+// The profile is written as collapsed stacks ("main;load;parse 123456"), which
+// flamegraph.pl, speedscope and inferno read directly:
+//
+//   ./flamegraph.pl --countname=bytes heap-profile.collapsed > heap.svg
+//
+// Compile: g++ -std=c++17 -O2 -g -fno-omit-frame-pointer -rdynamic sampling-heap-profiler.cpp -o sampling-heap-profiler
+// Run    : ./sampling-heap-profiler [interval_bytes]   (default 524288)
+//
+// Linux / macOS only — requires execinfo.h and dladdr.
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------
+// Sampling state — all per-thread, plain data, safe inside operator new
+// ---------------------------------------------------------------
+static std::atomic<std::int64_t> g_sample_interval { 512 * 1024 };
+static std::atomic<bool>         g_profiler_enabled { false };
+
+struct t_ThreadSampler
+{
+    std::int64_t  bytes_until_sample = 0;   // 0 → draw on first allocation
+    std::uint64_t rng_state          = 0;
+    bool          inside_profiler    = false;   // recursion guard (dladdr, demangle, ...)
+};
+
+static thread_local t_ThreadSampler g_sampler;
+
+// xorshift64* — tiny, allocation-free RNG; good enough to draw sampling gaps
+static double next_uniform(t_ThreadSampler& s)
+{
+    if (s.rng_state == 0)
+        s.rng_state = reinterpret_cast<std::uintptr_t>(&s) ^ 0x9E3779B97F4A7C15ull;
+
+    s.rng_state ^= s.rng_state >> 12;
+    s.rng_state ^= s.rng_state << 25;
+    s.rng_state ^= s.rng_state >> 27;
+    std::uint64_t bits = s.rng_state * 0x2545F4914F6CDD1Dull;
+    return (double(bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);   // (0, 1)
+}
+
+// Exponential gap with mean = interval → sampling points form a Poisson process
+static std::int64_t next_sample_gap(t_ThreadSampler& s)
+{
+    std::int64_t interval = g_sample_interval.load(std::memory_order_relaxed);
+    if (interval <= 1)
+        return 1;   // sample everything
+    return std::int64_t(-std::log(next_uniform(s)) * double(interval)) + 1;
+}
+
+// ---------------------------------------------------------------
+// t_StackTable — stack → (estimated bytes, estimated count), malloc-backed
+// ---------------------------------------------------------------
+static constexpr int MAX_FRAMES = 32;
+
+struct t_StackEntry
+{
+    std::uint64_t hash;          // 0 → empty slot
+    int           depth;
+    void*         frames[MAX_FRAMES];
+    double        est_bytes;
+    double        est_count;
+    std::uint64_t samples;
+};
+
+struct t_SpinLock
+{
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    void lock()   { while (flag.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag.clear(std::memory_order_release); }
+};
+
+class t_StackTable
+{
+    t_StackEntry* slots    = nullptr;
+    std::size_t   capacity = 0;
+    std::size_t   used     = 0;
+    t_SpinLock    mutex;
+
+    static std::uint64_t hash_stack(void* const* frames, int depth)
+    {
+        std::uint64_t h = 1469598103934665603ull;   // FNV-1a over the return addresses
+        for (int i = 0; i < depth; i++)
+        {
+            h ^= reinterpret_cast<std::uintptr_t>(frames[i]);
+            h *= 1099511628211ull;
+        }
+        return h ? h : 1;
+    }
+
+    t_StackEntry* find_slot(std::uint64_t hash, void* const* frames, int depth)
+    {
+        std::size_t i = hash & (capacity - 1);
+        while (slots[i].hash)
+        {
+            if (slots[i].hash == hash && slots[i].depth == depth &&
+                std::memcmp(slots[i].frames, frames, sizeof(void*) * std::size_t(depth)) == 0)
+                return &slots[i];
+            i = (i + 1) & (capacity - 1);
+        }
+        return &slots[i];
+    }
+
+    bool grow()
+    {
+        std::size_t   new_capacity = capacity ? capacity * 2 : 1024;
+        t_StackEntry* new_slots    = static_cast<t_StackEntry*>(std::calloc(new_capacity, sizeof(t_StackEntry)));
+        if (!new_slots)
+            return false;
+
+        t_StackEntry* old_slots    = slots;
+        std::size_t   old_capacity = capacity;
+        slots    = new_slots;
+        capacity = new_capacity;
+        for (std::size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_slots[i].hash)
+                *find_slot(old_slots[i].hash, old_slots[i].frames, old_slots[i].depth) = old_slots[i];
+        }
+        std::free(old_slots);
+        return true;
+    }
+
+public:
+    void record(void* const* frames, int depth, double est_bytes, double est_count)
+    {
+        std::uint64_t hash = hash_stack(frames, depth);
+
+        mutex.lock();
+        if ((used + 1) * 2 > capacity && !grow())
+        {
+            mutex.unlock();
+            return;
+        }
+        t_StackEntry* entry = find_slot(hash, frames, depth);
+        if (!entry->hash)
+        {
+            entry->hash  = hash;
+            entry->depth = depth;
+            std::memcpy(entry->frames, frames, sizeof(void*) * std::size_t(depth));
+            used++;
+        }
+        entry->est_bytes += est_bytes;
+        entry->est_count += est_count;
+        entry->samples++;
+        mutex.unlock();
+    }
+
+    // Copy out under the lock — symbolizing is slow and must not block allocators
+    std::vector<t_StackEntry> entries();
+};
+
+static t_StackTable g_stacks;
+
+std::vector<t_StackEntry> t_StackTable::entries()
+{
+    // push_back allocates while we hold the lock: it must never reach record()
+    bool was_inside           = g_sampler.inside_profiler;
+    g_sampler.inside_profiler = true;
+
+    std::vector<t_StackEntry> out;
+    mutex.lock();
+    for (std::size_t i = 0; i < capacity; i++)
+    {
+        if (slots[i].hash)
+            out.push_back(slots[i]);
+    }
+    mutex.unlock();
+
+    g_sampler.inside_profiler = was_inside;
+    return out;
+}
+
+// ---------------------------------------------------------------
+// Slow path — only reached for sampled allocations
+// ---------------------------------------------------------------
+[[gnu::noinline]] static void sample_allocation(t_ThreadSampler& s, std::size_t size)
+{
+    s.inside_profiler = true;
+
+    void* frames[MAX_FRAMES + 2];
+    int   depth = backtrace(frames, MAX_FRAMES + 2);
+
+    // Unbiased weight: this allocation stood for size / p bytes, 1 / p allocations
+    double interval = double(g_sample_interval.load(std::memory_order_relaxed));
+    double p        = interval <= 1 ? 1.0 : -std::expm1(-double(size) / interval);   // 1 - exp(-size / interval)
+
+    // Skip frame 0 (sample_allocation) and frame 1 (operator new)
+    int skip = depth > 2 ? 2 : depth;
+    g_stacks.record(frames + skip, depth - skip, double(size) / p, 1.0 / p);
+
+    // A fresh gap, not added to the deficit: a large allocation can leave the counter
+    // far below zero, and the allocations after it would all be sampled
+    s.bytes_until_sample = next_sample_gap(s);
+    s.inside_profiler    = false;
+}
+
+static inline void maybe_sample(std::size_t size)
+{
+    t_ThreadSampler& s = g_sampler;
+    s.bytes_until_sample -= std::int64_t(size);
+    if (s.bytes_until_sample > 0 || s.inside_profiler)
+        return;   // fast path: one subtract, one compare
+
+    if (!g_profiler_enabled.load(std::memory_order_relaxed))
+    {
+        s.bytes_until_sample = next_sample_gap(s);
+        return;
+    }
+    sample_allocation(s, size);
+}
+
+// ---------------------------------------------------------------
+// Hooks
+// ---------------------------------------------------------------
+void* operator new(std::size_t size)
+{
+    maybe_sample(size);
+
+    void* ptr = std::malloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+// Out of line, so GCC does not see free() paired with operator new (-Wmismatched-new-delete)
+[[gnu::noinline]] static void release(void* ptr) noexcept { std::free(ptr); }
+
+void  operator delete  (void* ptr) noexcept                     { release(ptr); }
+void  operator delete  (void* ptr, std::size_t /*size*/) noexcept { release(ptr); }
+void* operator new[]   (std::size_t size)                       { return ::operator new(size); }
+void  operator delete[](void* ptr) noexcept                     { release(ptr); }
+void  operator delete[](void* ptr, std::size_t /*size*/) noexcept { release(ptr); }
+
+// ---------------------------------------------------------------
+// Output — collapsed stacks, root first, weights in bytes
+// ---------------------------------------------------------------
+static std::string symbolize(void* address)
+{
+    // Return addresses point after the call; step back one byte to land inside it
+    void*   lookup = static_cast<char*>(address) - 1;
+    Dl_info info;
+    if (dladdr(lookup, &info) && info.dli_sname)
+    {
+        int   status    = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "0x%lx", (unsigned long)reinterpret_cast<std::uintptr_t>(lookup));
+    return buffer;
+}
+
+// ';' separates frames in the collapsed format, ' ' separates the weight
+static void sanitize_frame(std::string& name)
+{
+    for (char& c : name)
+    {
+        if (c == ';' || c == ' ')
+            c = '_';
+    }
+}
+
+static bool write_collapsed_profile(const char* path)
+{
+    g_sampler.inside_profiler = true;   // our own allocations here must not be sampled
+
+    std::FILE* out = std::fopen(path, "w");
+    if (!out)
+    {
+        g_sampler.inside_profiler = false;
+        return false;
+    }
+
+    for (const t_StackEntry& entry : g_stacks.entries())
+    {
+        // Start at main — the libc frames above it are the same for every stack
+        int root = entry.depth - 1;
+        for (int i = entry.depth - 1; i >= 0; i--)
+        {
+            if (symbolize(entry.frames[i]) == "main")
+            {
+                root = i;
+                break;
+            }
+        }
+
+        std::string line;
+        for (int i = root; i >= 0; i--)
+        {
+            std::string frame = symbolize(entry.frames[i]);
+            sanitize_frame(frame);
+            if (!line.empty())
+                line += ';';
+            line += frame;
+        }
+        std::fprintf(out, "%s %llu\n", line.c_str(), (unsigned long long)std::llround(entry.est_bytes));
+    }
+    std::fclose(out);
+
+    g_sampler.inside_profiler = false;
+    return true;
+}
+
+// ---------------------------------------------------------------
+// Usage — three call sites with very different allocation patterns
+// (not static: -rdynamic only exports external symbols for dladdr to find)
+// ---------------------------------------------------------------
+static std::size_t g_true_bytes[3];   // exact totals, to check the estimate
+
+[[gnu::noinline]] void parse_small_tokens(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        char* token = new char[24];   // many tiny allocations
+        token[0]    = char(i);
+        delete[] token;
+        g_true_bytes[0] += 24;
+    }
+}
+
+[[gnu::noinline]] void build_index(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        std::vector<int>* bucket = new std::vector<int>(1000);   // medium
+        delete bucket;
+        g_true_bytes[1] += sizeof(std::vector<int>) + 1000 * sizeof(int);
+    }
+}
+
+[[gnu::noinline]] void load_textures(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        char* texture = new char[4 * 1024 * 1024];   // few huge allocations
+        texture[0]    = char(i);
+        delete[] texture;
+        g_true_bytes[2] += 4 * 1024 * 1024;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        g_sample_interval = std::atoll(argv[1]);
+
+    // backtrace() loads libgcc lazily on first use, which allocates — warm it up
+    void* warmup[4];
+    backtrace(warmup, 4);
+    g_profiler_enabled = true;
+
+    auto start = std::chrono::steady_clock::now();
+    parse_small_tokens(5'000'000);
+    build_index(50'000);
+    load_textures(200);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    g_profiler_enabled = false;
+
+    const char* path = "heap-profile.collapsed";
+    if (!write_collapsed_profile(path))
+    {
+        std::printf("cannot write %s\n", path);
+        return 1;
+    }
+
+    std::printf("Workload took %.1f ms with sampling every %lld bytes on average\n",
+                ms, (long long)g_sample_interval.load());
+    std::printf("Wrote %s — render with: flamegraph.pl --countname=bytes %s > heap.svg\n\n", path, path);
+
+    // Estimated vs true bytes per call site
+    const char* sites[] = { "parse_small_tokens", "build_index", "load_textures" };
+    double estimated[3] = {};
+    std::uint64_t samples[3] = {};
+    for (const t_StackEntry& entry : g_stacks.entries())
+    {
+        for (int i = 0; i < entry.depth; i++)
+        {
+            std::string frame = symbolize(entry.frames[i]);
+            bool        found = false;
+            for (int s = 0; s < 3; s++)
+            {
+                if (frame.find(sites[s]) != std::string::npos)
+                {
+                    estimated[s] += entry.est_bytes;
+                    samples[s]   += entry.samples;
+                    found = true;
+                }
+            }
+            if (found)
+                break;
+        }
+    }
+
+    std::printf("%-20s  %14s  %14s  %8s  %8s\n", "call site", "true bytes", "estimated", "error", "samples");
+    for (int s = 0; s < 3; s++)
+    {
+        double error = 100.0 * (estimated[s] - double(g_true_bytes[s])) / double(g_true_bytes[s]);
+        std::printf("%-20s  %14zu  %14.0f  %+7.2f%%  %8llu\n", sites[s], g_true_bytes[s], estimated[s],
+                    error, (unsigned long long)samples[s]);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Slab allocator demo + churn benchmark against glibc malloc
+//
+// Compile: g++ -std=c++17 -O2 -pthread slab-allocator.cpp -o slab-allocator
+// Run    : ./slab-allocator          (PoolMixin demo)
+//          ./slab-allocator --bench  (random-order free churn vs malloc)
+
+#include "slab-allocator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------
+// Usage — Particle and Enemy backed by the slab heap, freed one by one
+// ---------------------------------------------------------------
+static SlabAllocator<> g_slab;
+
+class Particle : public PoolMixin<Particle, SlabAllocator<>>
+{
+public:
+    static SlabAllocator<>& s_pool;
+
+    float x, y, z, life;
+
+    Particle(float x, float y, float z)
+        : x(x), y(y), z(z), life(1.0f)
+    {}
+};
+
+SlabAllocator<>& Particle::s_pool = g_slab;
+
+class Enemy : public PoolMixin<Enemy, SlabAllocator<>>
+{
+public:
+    static SlabAllocator<>& s_pool;
+
+    int   health;
+    float pos[3];
+    char  name[40];
+
+    explicit Enemy(int hp) : health(hp), pos{}, name{} {}
+};
+
+SlabAllocator<>& Enemy::s_pool = g_slab;
+
+static void run_demo()
+{
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 10000; i++)
+        particles.push_back(new Particle(float(i), float(i * 2), 0.0f));
+
+    Enemy* boss = new Enemy(1000);
+    g_slab.print_usage("after spawning 10,000 particles");
+
+    // Mixed lifetimes: every other particle dies — memory goes back to the free list
+    for (std::size_t i = 0; i < particles.size(); i += 2)
+        delete particles[i];
+
+    // ...and new particles reuse exactly those blocks: no new slabs appear
+    for (std::size_t i = 0; i < particles.size(); i += 2)
+        particles[i] = new Particle(0.0f, 0.0f, 0.0f);
+    g_slab.print_usage("after freeing and respawning 5,000");
+
+    for (Particle* p : particles)
+        delete p;
+    delete boss;
+}
+
+// ---------------------------------------------------------------
+// Benchmark — N live objects of random sizes, random victim freed each step
+// ---------------------------------------------------------------
+struct t_MallocBackend
+{
+    static const char* name() { return "glibc malloc"; }
+    void* alloc(std::size_t size) { return std::malloc(size); }
+    void  free(void* ptr, std::size_t /*size*/) { std::free(ptr); }
+};
+
+struct t_SlabBackend
+{
+    static const char* name() { return "slab"; }
+    SlabAllocator<t_SlabBackend> slab;
+    void* alloc(std::size_t size) { return slab.alloc(size); }
+    void  free(void* ptr, std::size_t size) { slab.free(ptr, size); }
+};
+
+struct t_Live
+{
+    void*       ptr;
+    std::size_t size;
+};
+
+template<typename Backend>
+static std::uint64_t churn(std::size_t live, std::size_t steps, std::size_t max_size, unsigned seed)
+{
+    Backend             backend;
+    std::mt19937_64     rng(seed);
+    std::vector<t_Live> objects(live);
+    std::uint64_t       checksum = 0;
+
+    for (t_Live& obj : objects)
+    {
+        obj.size = 8 + rng() % max_size;
+        obj.ptr  = backend.alloc(obj.size);
+        std::memset(obj.ptr, 1, 8);   // touch it like a real constructor would
+    }
+
+    for (std::size_t i = 0; i < steps; i++)
+    {
+        t_Live& victim = objects[rng() % live];
+        checksum += *static_cast<unsigned char*>(victim.ptr);
+        backend.free(victim.ptr, victim.size);
+
+        victim.size = 8 + rng() % max_size;
+        victim.ptr  = backend.alloc(victim.size);
+        std::memset(victim.ptr, 1, 8);
+    }
+
+    for (t_Live& obj : objects)
+        backend.free(obj.ptr, obj.size);
+    return checksum;
+}
+
+template<typename Backend>
+static void bench(unsigned threads, std::size_t live, std::size_t steps, std::size_t max_size)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back([=] { churn<Backend>(live, steps, max_size, 42 + t); });
+    for (std::thread& w : workers)
+        w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ops = double(threads) * double(steps + live);
+    std::printf("  %-14s threads=%u  %7.1f ns per free+alloc  (%6.1f M ops/s total)\n",
+                Backend::name(), threads, seconds * 1e9 / (ops / threads), ops / seconds / 1e6);
+}
+
+static void run_benchmark()
+{
+    constexpr std::size_t STEPS = 5'000'000;
+
+    for (std::size_t max_size : { std::size_t(64), std::size_t(512) })
+    {
+        for (std::size_t live : { std::size_t(10'000), std::size_t(1'000'000) })
+        {
+            std::printf("live=%zu  sizes 8..%zu B\n", live, max_size + 7);
+            for (unsigned threads : { 1u, 4u })
+            {
+                bench<t_MallocBackend>(threads, live, STEPS, max_size);
+                bench<t_SlabBackend>(threads, live, STEPS, max_size);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+        run_benchmark();
+    else
+        run_demo();
+    return 0;
+}
@@ -0,0 +1,315 @@
+// Size-class slab allocator with per-thread caches
+//
+// PoolAllocator (Memory_allocation_debugging.md, Level 8) can only free everything at
+// once. SlabAllocator frees individual objects in O(1):
+//
+//   alloc(size) → round up to a size class → pop the thread's free list
+//   free(ptr)   → push onto the thread's free list
+//
+// Each size class owns 64 KiB slabs carved into equal blocks. A free block stores the
+// "next" pointer inside itself (intrusive free list), so there is no per-object header.
+// Threads pop and push on their own cache without locking; only when a cache runs dry
+// or overflows is a whole batch moved to/from the central list under a spinlock.
+//
+// Slabs are never returned to the OS — like any pool, memory is reused, not released.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+namespace slab_detail
+{
+    // 16-byte steps up to 128, then four classes per power of two up to 2 KiB
+    inline constexpr std::size_t CLASS_SIZES[] = {
+        16,   32,   48,   64,   80,   96,   112,  128,
+        160,  192,  224,  256,  320,  384,  448,  512,
+        640,  768,  896,  1024, 1280, 1536, 1792, 2048,
+    };
+    inline constexpr std::size_t CLASS_COUNT = sizeof(CLASS_SIZES) / sizeof(CLASS_SIZES[0]);
+    inline constexpr std::size_t MAX_SIZE    = CLASS_SIZES[CLASS_COUNT - 1];
+    inline constexpr std::size_t SLAB_SIZE   = 64 * 1024;
+    inline constexpr std::size_t SLAB_ALIGN  = 4096;   // blocks of size 2^k are 2^k aligned
+
+    // class_for_granule[g] = smallest class holding g * 16 bytes, built at compile time
+    struct t_ClassTable
+    {
+        unsigned char class_for_granule[MAX_SIZE / 16 + 1] = {};
+
+        constexpr t_ClassTable()
+        {
+            std::size_t c = 0;
+            for (std::size_t g = 0; g <= MAX_SIZE / 16; g++)
+            {
+                while (CLASS_SIZES[c] < g * 16)
+                    c++;
+                class_for_granule[g] = (unsigned char)c;
+            }
+        }
+    };
+    inline constexpr t_ClassTable CLASS_TABLE{};
+
+    // Smallest class that fits 'size' and keeps every block aligned to 'align'
+    // (a block at offset k * class_size is aligned when class_size % align == 0)
+    constexpr int class_index(std::size_t size, std::size_t align)
+    {
+        if (size > MAX_SIZE)
+            return -1;
+        if (align <= 16)   // every class is a multiple of 16: one table lookup
+            return CLASS_TABLE.class_for_granule[(size + 15) / 16];
+
+        for (std::size_t i = CLASS_TABLE.class_for_granule[(size + 15) / 16]; i < CLASS_COUNT; i++)
+        {
+            if ((CLASS_SIZES[i] & (align - 1)) == 0)
+                return int(i);
+        }
+        return -1;
+    }
+
+    // How many blocks move between a thread cache and the central list at once
+    constexpr std::size_t batch_size(std::size_t class_size)
+    {
+        std::size_t n = 8192 / class_size;
+        return n < 8 ? 8 : (n > 64 ? 64 : n);
+    }
+
+    // Lives inside a free block (the smallest class is 16 bytes, so both fit)
+    struct t_FreeBlock
+    {
+        t_FreeBlock* next;         // next block in the same list
+        t_FreeBlock* next_batch;   // only on the first block of a full batch
+    };
+
+    struct t_SpinLock
+    {
+        std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+        void lock()   { while (flag.test_and_set(std::memory_order_acquire)) {} }
+        void unlock() { flag.clear(std::memory_order_release); }
+    };
+}
+
+// ---------------------------------------------------------------
+// SlabAllocator<Tag>
+//
+// All SlabAllocator objects with the same Tag share one heap (the state is static),
+// so a pool can be declared wherever it is needed and still be passed to PoolMixin
+// just like PoolAllocator. Use a different Tag for an independent heap.
+// ---------------------------------------------------------------
+template<typename Tag = void>
+class SlabAllocator
+{
+    using t_FreeBlock = slab_detail::t_FreeBlock;
+
+    // Shared per size class — touched only when a thread cache refills or drains.
+    // Full batches are kept as whole chains, so moving one costs O(1), not a list walk.
+    struct t_CentralList
+    {
+        slab_detail::t_SpinLock mutex;
+        t_FreeBlock*            batches    = nullptr;   // chains of exactly batch_size blocks
+        t_FreeBlock*            loose      = nullptr;   // leftovers from exiting threads
+        char*                   carve_next = nullptr;   // unused tail of the newest slab
+        char*                   carve_end  = nullptr;
+        std::size_t             slab_count = 0;
+    };
+
+    // Per thread, per size class — no atomics, no locks
+    struct t_ThreadCache
+    {
+        t_FreeBlock* head[slab_detail::CLASS_COUNT]  = {};
+        std::size_t  count[slab_detail::CLASS_COUNT] = {};
+
+        // Thread exit: give everything back so other threads can reuse it
+        ~t_ThreadCache()
+        {
+            for (std::size_t i = 0; i < slab_detail::CLASS_COUNT; i++)
+            {
+                s_central[i].mutex.lock();
+                while (head[i])
+                {
+                    t_FreeBlock* block = head[i];
+                    head[i]            = block->next;
+                    block->next        = s_central[i].loose;
+                    s_central[i].loose = block;
+                }
+                s_central[i].mutex.unlock();
+                count[i] = 0;   // late frees from other thread_local destructors start afresh
+            }
+        }
+    };
+
+    static inline t_CentralList                 s_central[slab_detail::CLASS_COUNT];
+    static inline thread_local t_ThreadCache    s_cache;
+    static inline std::atomic<std::size_t>      s_large_count { 0 };
+
+    // Give the thread cache one batch: a whole recycled chain if there is one,
+    // otherwise loose blocks, otherwise freshly carved slab memory
+    static t_FreeBlock* refill(std::size_t index)
+    {
+        const std::size_t class_size = slab_detail::CLASS_SIZES[index];
+        const std::size_t batch      = slab_detail::batch_size(class_size);
+        t_CentralList&    central    = s_central[index];
+
+        t_FreeBlock* head  = nullptr;
+        std::size_t  taken = 0;
+
+        central.mutex.lock();
+        if (central.batches)
+        {
+            head            = central.batches;
+            central.batches = head->next_batch;
+            taken           = batch;
+        }
+        while (taken < batch && central.loose)
+        {
+            t_FreeBlock* block = central.loose;
+            central.loose      = block->next;
+            block->next        = head;
+            head               = block;
+            taken++;
+        }
+        while (taken < batch)
+        {
+            if (central.carve_next == central.carve_end)
+            {
+                void* slab = std::aligned_alloc(slab_detail::SLAB_ALIGN, slab_detail::SLAB_SIZE);
+                if (!slab)
+                    break;
+                central.carve_next = static_cast<char*>(slab);
+                central.carve_end  = central.carve_next + slab_detail::SLAB_SIZE / class_size * class_size;
+                central.slab_count++;
+            }
+            t_FreeBlock* block = reinterpret_cast<t_FreeBlock*>(central.carve_next);
+            central.carve_next += class_size;
+            block->next         = head;
+            head                = block;
+            taken++;
+        }
+        central.mutex.unlock();
+
+        s_cache.head[index]  = head;
+        s_cache.count[index] = taken;
+        return head;
+    }
+
+    // Hand the most recently freed batch (still hot in this core's cache) to the
+    // central list and keep the rest
+    static void drain(std::size_t index)
+    {
+        const std::size_t batch = slab_detail::batch_size(slab_detail::CLASS_SIZES[index]);
+        t_FreeBlock*      first = s_cache.head[index];
+        t_FreeBlock*      last  = first;
+        for (std::size_t i = 1; i < batch; i++)
+            last = last->next;
+
+        s_cache.head[index]   = last->next;
+        s_cache.count[index] -= batch;
+        last->next            = nullptr;
+
+        t_CentralList& central = s_central[index];
+        central.mutex.lock();
+        first->next_batch = central.batches;
+        central.batches   = first;
+        central.mutex.unlock();
+    }
+
+public:
+    static constexpr std::size_t max_size = slab_detail::MAX_SIZE;
+
+    void* alloc(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        int index = slab_detail::class_index(size, align);
+        if (index < 0)   // too big or too aligned for a slab — go to the system
+        {
+            s_large_count.fetch_add(1, std::memory_order_relaxed);
+            void* ptr = ::operator new(size, std::align_val_t(align));
+            return ptr;
+        }
+
+        t_FreeBlock* block = s_cache.head[index];
+        if (!block && !(block = refill(std::size_t(index))))
+            throw std::bad_alloc();
+
+        s_cache.head[index] = block->next;
+        s_cache.count[index]--;
+        return block;
+    }
+
+    // 'size' and 'align' must match the alloc() call — they select the size class
+    void free(void* ptr, std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept
+    {
+        if (!ptr)
+            return;
+
+        int index = slab_detail::class_index(size, align);
+        if (index < 0)
+        {
+            s_large_count.fetch_sub(1, std::memory_order_relaxed);
+            ::operator delete(ptr, std::align_val_t(align));
+            return;
+        }
+
+        t_FreeBlock* block  = static_cast<t_FreeBlock*>(ptr);
+        block->next         = s_cache.head[index];
+        s_cache.head[index] = block;
+
+        // A thread that only frees (consumer of a producer thread) must not hoard memory
+        if (++s_cache.count[index] > 2 * slab_detail::batch_size(slab_detail::CLASS_SIZES[index]))
+            drain(std::size_t(index));
+    }
+
+    void print_usage(const char* label = "Slab") const
+    {
+        std::size_t total_slabs = 0;
+        std::printf("[%s]\n", label);
+        for (std::size_t i = 0; i < slab_detail::CLASS_COUNT; i++)
+        {
+            s_central[i].mutex.lock();
+            std::size_t slabs = s_central[i].slab_count;
+            s_central[i].mutex.unlock();
+
+            if (slabs)
+                std::printf("  class %5zu B  slabs=%zu\n", slab_detail::CLASS_SIZES[i], slabs);
+            total_slabs += slabs;
+        }
+        std::printf("  reserved=%zu KiB  large (system) allocations live=%zu\n",
+                    total_slabs * slab_detail::SLAB_SIZE / 1024,
+                    s_large_count.load(std::memory_order_relaxed));
+    }
+};
+
+// ---------------------------------------------------------------
+// PoolMixin<Derived, Pool> — CRTP to attach a pool to a class
+//
+// Same mixin as in the guide, but delete now returns memory to pools that can free
+// individual objects (SlabAllocator). Bump pools without free() (PoolAllocator)
+// keep the old behaviour: memory comes back on reset().
+// ---------------------------------------------------------------
+template<typename Pool, typename = void>
+struct t_HasFree : std::false_type {};
+
+template<typename Pool>
+struct t_HasFree<Pool, std::void_t<decltype(std::declval<Pool&>().free(nullptr, std::size_t(), std::size_t()))>>
+    : std::true_type {};
+
+template<typename Derived, typename Pool>
+class PoolMixin
+{
+public:
+    static void* operator new(std::size_t size)
+    {
+        return Derived::s_pool.alloc(size, alignof(Derived));
+    }
+
+    // Sized delete: the size class is known without any per-object header
+    static void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        if constexpr (t_HasFree<Pool>::value)
+            Derived::s_pool.free(ptr, size, alignof(Derived));
+        else
+            (void)ptr, (void)size;   // reclaimed by pool.reset()
+    }
+};